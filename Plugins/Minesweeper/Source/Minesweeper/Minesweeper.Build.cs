@@ -27,6 +27,7 @@ public class Minesweeper : ModuleRules
 				"ToolMenus",
 				"CoreUObject",
 				"Engine",
+				"Json",
 				"Slate",
 				"SlateCore"
 			}
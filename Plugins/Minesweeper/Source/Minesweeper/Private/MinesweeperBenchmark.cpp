@@ -0,0 +1,139 @@
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "MinesweeperCore.h"
+
+#include "HAL/IConsoleManager.h"
+#include "MinesweeperLog.h"
+
+namespace MinesweeperBenchmark
+{
+	struct FLayoutResult
+	{
+		double GenerateSeconds = 0.0;
+		double FloodSeconds = 0.0;
+		int32 RevealedTiles = 0;
+		uint64 BoardHash = 0;
+	};
+
+	/** Finds the zero tile closest to the top left corner, scanning anti-diagonals so the flood starts as far from the opposite corner as possible */
+	bool FindCornerZeroTile(const FMinesweeperCore& Core, int32& OutX, int32& OutY)
+	{
+		const FMinesweeperBoard& Board = Core.GetBoard();
+		const int32 Width = Board.GetWidth();
+		const int32 Height = Board.GetHeight();
+
+		for (int32 Diagonal = 0; Diagonal < Width + Height - 1; ++Diagonal)
+		{
+			for (int32 X = FMath::Max(0, Diagonal - Height + 1); X <= FMath::Min(Diagonal, Width - 1); ++X)
+			{
+				const int32 CellIndex = Board.GetCellIndex(X, Diagonal - X);
+				if (!Board.IsBomb(CellIndex) && Board.GetAdjacentBombs(CellIndex) == 0)
+				{
+					OutX = X;
+					OutY = Diagonal - X;
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+	/** Finds the zero tile of the given zero region closest to the bottom right corner, scanning anti-diagonals backwards */
+	bool FindFarCornerZeroTile(const FMinesweeperCore& Core, const int32 ZeroRegion, int32& OutX, int32& OutY)
+	{
+		const FMinesweeperBoard& Board = Core.GetBoard();
+		const int32 Width = Board.GetWidth();
+		const int32 Height = Board.GetHeight();
+
+		for (int32 Diagonal = Width + Height - 2; Diagonal >= 0; --Diagonal)
+		{
+			for (int32 X = FMath::Min(Diagonal, Width - 1); X >= FMath::Max(0, Diagonal - Height + 1); --X)
+			{
+				if (Board.GetZeroRegion(Board.GetCellIndex(X, Diagonal - X)) == ZeroRegion)
+				{
+					OutX = X;
+					OutY = Diagonal - X;
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+	FLayoutResult RunLayout(const FMinesweeperGameSettings& Settings)
+	{
+		FLayoutResult Result;
+		FMinesweeperCore Core;
+
+		const double GenerateStart = FPlatformTime::Seconds();
+		Core.InitializeGame(Settings);
+		Result.GenerateSeconds = FPlatformTime::Seconds() - GenerateStart;
+		Result.BoardHash = Core.GetBoardHash();
+
+		int32 StartX, StartY;
+		if (FindCornerZeroTile(Core, StartX, StartY))
+		{
+			// Boards with precomputed zero regions would reveal the opening in bulk. A flag inside it rules that out, so the flood itself is timed.
+			const int32 StartRegion = Core.GetBoard().GetZeroRegion(Core.GetBoard().GetCellIndex(StartX, StartY));
+			int32 FlagX, FlagY;
+			if (StartRegion != INDEX_NONE && FindFarCornerZeroTile(Core, StartRegion, FlagX, FlagY) && (FlagX != StartX || FlagY != StartY))
+			{
+				Core.ToggleFlag(FlagX, FlagY);
+			}
+
+			const double FloodStart = FPlatformTime::Seconds();
+			Core.RevealTile(StartX, StartY);
+			Result.FloodSeconds = FPlatformTime::Seconds() - FloodStart;
+		}
+
+		Result.RevealedTiles = Core.GetRevealedTileCount();
+		return Result;
+	}
+
+	/**
+	 * Generates the same seeded board in each cell layout and times a corner-to-corner flood on it
+	 * Low mine densities give one opening spanning the whole board, which is the diagonal-heavy case
+	 * the blocked layout exists for. The flood stops short of one flagged tile in the far corner of the opening,
+	 * which keeps the core from revealing the opening through its precomputed zero region.
+	 */
+	void BenchmarkLayouts(const TArray<FString>& Args)
+	{
+		const int32 Size = Args.IsValidIndex(0) ? FCString::Atoi(*Args[0]) : 4096;
+		const int32 MineDensityPercent = Args.IsValidIndex(1) ? FCString::Atoi(*Args[1]) : 2;
+		const int32 Seed = Args.IsValidIndex(2) ? FCString::Atoi(*Args[2]) : 1;
+
+		FMinesweeperGameSettings Settings(Size, Size, 1, FMath::Max(Seed, 1));
+		Settings.bLargeBoard = true;
+		Settings.ValidateAndClamp();
+		Settings.BombCount = FMath::Max(1, static_cast<int32>(int64(Settings.GridWidth) * Settings.GridHeight * FMath::Clamp(MineDensityPercent, 0, 100) / 100));
+		Settings.ValidateAndClamp();
+
+		Settings.CellLayout = EMinesweeperCellLayout::RowMajor;
+		const FLayoutResult RowMajor = RunLayout(Settings);
+
+		Settings.CellLayout = EMinesweeperCellLayout::Blocked8x8;
+		const FLayoutResult Blocked = RunLayout(Settings);
+
+		MS_DISPLAY("Layout benchmark %dx%d, %d bombs, seed %d", Settings.GridWidth, Settings.GridHeight, Settings.BombCount, Settings.RandomSeed);
+		MS_DISPLAY("  RowMajor:   generate %.2f ms, flood %.2f ms, %d tiles revealed", RowMajor.GenerateSeconds * 1000.0, RowMajor.FloodSeconds * 1000.0, RowMajor.RevealedTiles);
+		MS_DISPLAY("  Blocked8x8: generate %.2f ms, flood %.2f ms, %d tiles revealed", Blocked.GenerateSeconds * 1000.0, Blocked.FloodSeconds * 1000.0, Blocked.RevealedTiles);
+
+		if (Blocked.FloodSeconds > 0.0)
+		{
+			MS_DISPLAY("  Flood speedup: %.2fx", RowMajor.FloodSeconds / Blocked.FloodSeconds);
+		}
+
+		if (RowMajor.BoardHash != Blocked.BoardHash || RowMajor.RevealedTiles != Blocked.RevealedTiles)
+		{
+			MS_ERROR("Layouts disagree: hash %016llx vs %016llx, revealed %d vs %d", RowMajor.BoardHash, Blocked.BoardHash, RowMajor.RevealedTiles, Blocked.RevealedTiles);
+		}
+	}
+
+	static FAutoConsoleCommand BenchmarkLayoutsCommand(
+		TEXT("Minesweeper.BenchmarkLayouts"),
+		TEXT("Times board generation and a corner-to-corner flood in each cell layout. Args: [Size=4096] [MineDensityPercent=2] [Seed=1]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkLayouts));
+}
@@ -0,0 +1,741 @@
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "MinesweeperBoard.h"
+
+#include "Async/ParallelFor.h"
+#include "Hash/CityHash.h"
+#include "MinesweeperStats.h"
+
+void FMinesweeperBoard::Initialize(const int32 InWidth, const int32 InHeight, const EMinesweeperCellLayout InLayout)
+{
+	Width = InWidth;
+	Height = InHeight;
+	Layout = InLayout;
+
+	int32 NumWords = 0;
+	if (Layout == EMinesweeperCellLayout::RowMajor)
+	{
+		// One border cell on each side, rounded up so every row starts on a word boundary
+		Stride = FMath::DivideAndRoundUp(Width + 2, 64) * 64;
+		RowWords = Stride / 64;
+		BlocksPerRow = 0;
+		BlockRows = 0;
+
+		PlayableRowMask.Init(0, RowWords);
+		for (int32 Column = 1; Column <= Width; ++Column)
+		{
+			PlayableRowMask[Column >> 6] |= uint64(1) << (Column & 63);
+		}
+
+		NumWords = RowWords * (Height + 2);
+	}
+	else
+	{
+		// Enough 8x8 blocks to hold the tiles plus their border ring
+		Stride = 0;
+		RowWords = 0;
+		BlocksPerRow = FMath::DivideAndRoundUp(Width + 2, 8);
+		BlockRows = FMath::DivideAndRoundUp(Height + 2, 8);
+
+		PlayableRowMask.Empty();
+		NumWords = BlocksPerRow * BlockRows;
+	}
+
+	for (int32 Direction = 0; Direction < NumNeighbors; ++Direction)
+	{
+		NeighborOffsets[Direction] = NeighborDeltaY[Direction] * Stride + NeighborDeltaX[Direction];
+
+		// Lane (X, Y) of a block, stepping off the block edge moves to the adjacent block
+		for (int32 Lane = 0; Lane < 64; ++Lane)
+		{
+			const int32 NeighborX = (Lane & 7) + NeighborDeltaX[Direction];
+			const int32 NeighborY = (Lane >> 3) + NeighborDeltaY[Direction];
+			const int32 BlockDelta = (NeighborY >> 3) * BlocksPerRow + (NeighborX >> 3);
+			BlockNeighborOffsets[Lane][Direction] = BlockDelta * 64 + ((NeighborY & 7) << 3) + (NeighborX & 7) - Lane;
+		}
+	}
+
+	BombPlane.Init(0, NumWords);
+	FlaggedPlane.Init(0, NumWords);
+
+	// Border cells count as revealed, which is what stops neighbour walks at the edge of the board
+	RevealedPlane.SetNumUninitialized(NumWords);
+	for (int32 WordIndex = 0; WordIndex < NumWords; ++WordIndex)
+	{
+		RevealedPlane[WordIndex] = ~GetPlayableMask(WordIndex);
+	}
+
+	// 64 cells per word, two cells per byte
+	AdjacentCounts.Init(0, NumWords * 32);
+
+	ZeroRegionLabels.Empty();
+	ZeroRegionStarts.Empty();
+	ZeroRegionWords.Empty();
+	ZeroRegionMasks.Empty();
+}
+
+void FMinesweeperBoard::Empty()
+{
+	Width = 0;
+	Height = 0;
+	Stride = 0;
+	RowWords = 0;
+	BlocksPerRow = 0;
+	BlockRows = 0;
+
+	PlayableRowMask.Empty();
+	BombPlane.Empty();
+	RevealedPlane.Empty();
+	FlaggedPlane.Empty();
+	AdjacentCounts.Empty();
+
+	ZeroRegionLabels.Empty();
+	ZeroRegionStarts.Empty();
+	ZeroRegionWords.Empty();
+	ZeroRegionMasks.Empty();
+}
+
+int32 FMinesweeperBoard::CellToTileIndex(const int32 CellIndex) const
+{
+	int32 X, Y;
+	GetCellCoordinates(CellIndex, X, Y);
+	return GetTileIndex(X, Y);
+}
+
+void FMinesweeperBoard::GetCellCoordinates(const int32 CellIndex, int32& OutX, int32& OutY) const
+{
+	if (Layout == EMinesweeperCellLayout::RowMajor)
+	{
+		OutX = CellIndex % Stride - 1;
+		OutY = CellIndex / Stride - 1;
+		return;
+	}
+
+	const int32 Block = CellIndex >> 6;
+	const int32 Lane = CellIndex & 63;
+	OutX = (Block % BlocksPerRow) * 8 + (Lane & 7) - 1;
+	OutY = (Block / BlocksPerRow) * 8 + (Lane >> 3) - 1;
+}
+
+uint64 FMinesweeperBoard::GetPlayableMask(const int32 WordIndex) const
+{
+	if (Layout == EMinesweeperCellLayout::RowMajor)
+	{
+		const int32 Row = WordIndex / RowWords;
+		return (Row >= 1 && Row <= Height) ? PlayableRowMask[WordIndex % RowWords] : 0;
+	}
+
+	// Playable columns of the block repeated on every row, then limited to the playable rows
+	const int32 BaseX = (WordIndex % BlocksPerRow) * 8;
+	const int32 BaseY = (WordIndex / BlocksPerRow) * 8;
+
+	const int32 FirstColumn = FMath::Max(1 - BaseX, 0);
+	const int32 LastColumn = FMath::Min(Width - BaseX, 7);
+	const int32 FirstRow = FMath::Max(1 - BaseY, 0);
+	const int32 LastRow = FMath::Min(Height - BaseY, 7);
+
+	if (FirstColumn > LastColumn || FirstRow > LastRow)
+	{
+		return 0;
+	}
+
+	const uint64 ColumnBits = (uint64(0xFF) >> (7 - LastColumn)) & (uint64(0xFF) << FirstColumn);
+	const uint64 RowBits = (~uint64(0) >> ((7 - LastRow) * 8)) & (~uint64(0) << (FirstRow * 8));
+	return (ColumnBits * 0x0101010101010101ull) & RowBits;
+}
+
+void FMinesweeperBoard::SetAdjacentBombs(const int32 Index, const int32 Count)
+{
+	const int32 Shift = (Index & 1) << 2;
+	uint8& Packed = AdjacentCounts[Index >> 1];
+	Packed = (Packed & ~(0xF << Shift)) | ((Count & 0xF) << Shift);
+}
+
+FMinesweeperTile FMinesweeperBoard::GetTile(const int32 Index) const
+{
+	FMinesweeperTile Tile;
+	Tile.bIsBomb = IsBomb(Index);
+	Tile.bIsRevealed = IsRevealed(Index);
+	Tile.bIsFlagged = IsFlagged(Index);
+	Tile.AdjacentBombs = GetAdjacentBombs(Index);
+	return Tile;
+}
+
+// ==== Whole-board operations
+
+void FMinesweeperBoard::RevealBombsAndFlags(const bool bFlagBombs, TArray<FMinesweeperTileChange>* OutChanges)
+{
+	for (int32 WordIndex = 0; WordIndex < BombPlane.Num(); ++WordIndex)
+	{
+		const uint64 Mask = BombPlane[WordIndex] | FlaggedPlane[WordIndex];
+
+		// Lanes this word is about to change, recorded before the planes are written
+		uint64 Changed = (Mask & ~RevealedPlane[WordIndex]) | (bFlagBombs ? Mask & ~FlaggedPlane[WordIndex] : 0);
+		while (OutChanges && Changed != 0)
+		{
+			const int32 CellIndex = WordIndex * 64 + static_cast<int32>(FMath::CountTrailingZeros64(Changed));
+			const EMinesweeperTileState OldState = GetTileState(CellIndex);
+			const EMinesweeperTileState NewState = OldState | EMinesweeperTileState::Revealed | (bFlagBombs ? EMinesweeperTileState::Flagged : EMinesweeperTileState::None);
+			OutChanges->Emplace(CellToTileIndex(CellIndex), OldState, NewState);
+			Changed &= Changed - 1;
+		}
+
+		RevealedPlane[WordIndex] |= Mask;
+
+		if (bFlagBombs)
+		{
+			FlaggedPlane[WordIndex] |= Mask;
+		}
+	}
+}
+
+int32 FMinesweeperBoard::CountCorrectFlags() const
+{
+	int32 Count = 0;
+	for (int32 WordIndex = 0; WordIndex < BombPlane.Num(); ++WordIndex)
+	{
+		Count += FMath::CountBits(BombPlane[WordIndex] & FlaggedPlane[WordIndex]);
+	}
+	return Count;
+}
+
+int32 FMinesweeperBoard::CountIncorrectFlags() const
+{
+	int32 Count = 0;
+	for (int32 WordIndex = 0; WordIndex < BombPlane.Num(); ++WordIndex)
+	{
+		Count += FMath::CountBits(~BombPlane[WordIndex] & FlaggedPlane[WordIndex]);
+	}
+	return Count;
+}
+
+// ==== Adjacent bomb counts
+
+namespace MinesweeperBoard
+{
+	/** Adds three 1-bit lanes, returning the sum bit and the carry bit */
+	FORCEINLINE void FullAdd(const uint64 A, const uint64 B, const uint64 C, uint64& OutSum, uint64& OutCarry)
+	{
+		const uint64 AXorB = A ^ B;
+		OutSum = AXorB ^ C;
+		OutCarry = (A & B) | (C & AXorB);
+	}
+
+	/** Bit-sliced sum of 8 neighbour masks into a 4-bit count per lane */
+	FORCEINLINE void SumNeighborMasks(const uint64 NW, const uint64 N, const uint64 NE, const uint64 W, const uint64 E, const uint64 SW, const uint64 S, const uint64 SE,
+		uint64& OutBit0, uint64& OutBit1, uint64& OutBit2, uint64& OutBit3)
+	{
+		uint64 SumA, CarryA, SumB, CarryB;
+		FullAdd(NW, N, NE, SumA, CarryA);
+		FullAdd(W, E, SW, SumB, CarryB);
+		const uint64 SumD = S ^ SE;
+		const uint64 CarryD = S & SE;
+
+		uint64 CarryOnes;
+		FullAdd(SumA, SumB, SumD, OutBit0, CarryOnes);
+
+		uint64 SumTwos, CarryTwos;
+		FullAdd(CarryA, CarryB, CarryD, SumTwos, CarryTwos);
+		OutBit1 = SumTwos ^ CarryOnes;
+		const uint64 CarryFours = SumTwos & CarryOnes;
+
+		OutBit2 = CarryTwos ^ CarryFours;
+		OutBit3 = CarryTwos & CarryFours;
+	}
+
+	/**
+	 * Split of the storage rows into contiguous bands for ParallelFor
+	 * Bands only depend on the board size, never on the worker count, so parallel passes visit the same
+	 * cells in the same groups on every machine.
+	 */
+	struct FRowBands
+	{
+		/** Smallest band worth handing to a worker */
+		static constexpr int32 MinCellsPerBand = 64 * 1024;
+
+		FRowBands(const int32 NumRows, const int32 CellsPerRow, const bool bParallel)
+		{
+			const int64 NumCells = static_cast<int64>(NumRows) * CellsPerRow;
+			Num = bParallel ? static_cast<int32>(FMath::Clamp<int64>(NumCells / MinCellsPerBand, 1, NumRows)) : 1;
+			RowsPerBand = FMath::DivideAndRoundUp(NumRows, Num);
+			TotalRows = NumRows;
+		}
+
+		int32 GetFirstRow(const int32 Band) const { return FMath::Min(Band * RowsPerBand, TotalRows); }
+		int32 GetEndRow(const int32 Band) const { return FMath::Min((Band + 1) * RowsPerBand, TotalRows); }
+		EParallelForFlags GetFlags() const { return Num > 1 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread; }
+
+		int32 Num = 1;
+		int32 RowsPerBand = 0;
+		int32 TotalRows = 0;
+	};
+
+	/**
+	 * Polls a progress callback before each band of a pass, with the share of bands finished so far
+	 * Once the callback refused, every band that has not started yet is skipped.
+	 */
+	class FBandProgress
+	{
+	public:
+		FBandProgress(const int32 InNumBands, const TFunctionRef<bool(const float)> InOnProgress)
+			: NumBands(InNumBands)
+			, OnProgress(InOnProgress) {}
+
+		/** Returns false when the band must be skipped */
+		bool BeginBand()
+		{
+			if (bAbandoned || !OnProgress(static_cast<float>(NumFinishedBands) / NumBands))
+			{
+				bAbandoned = true;
+				return false;
+			}
+
+			return true;
+		}
+
+		void EndBand() { ++NumFinishedBands; }
+		bool WasAbandoned() const { return bAbandoned; }
+
+	private:
+		const int32 NumBands;
+		const TFunctionRef<bool(const float)> OnProgress;
+		std::atomic<int32> NumFinishedBands = 0;
+		std::atomic<bool> bAbandoned = false;
+	};
+}
+
+bool FMinesweeperBoard::ComputeAdjacentCounts(const bool bParallel, const TFunctionRef<bool(const float)> OnProgress)
+{
+	MS_SCOPE_CYCLE_COUNTER(STAT_Minesweeper_ComputeAdjacentCounts);
+
+	FMemory::Memzero(AdjacentCounts.GetData(), AdjacentCounts.Num());
+
+	// Every word of counts only depends on the bomb plane, so bands read their halo rows straight from
+	// it and write disjoint ranges of the count array
+	const MinesweeperBoard::FRowBands Bands(GetNumStorageRows(), GetCellsPerStorageRow(), bParallel);
+	MinesweeperBoard::FBandProgress BandProgress(Bands.Num, OnProgress);
+
+	ParallelFor(Bands.Num, [this, &Bands, &BandProgress](const int32 Band) {
+		if (!BandProgress.BeginBand())
+			return;
+
+		if (Layout == EMinesweeperCellLayout::RowMajor)
+		{
+			ComputeAdjacentCountsRowMajor(Bands.GetFirstRow(Band), Bands.GetEndRow(Band));
+		}
+		else
+		{
+			ComputeAdjacentCountsBlocked(Bands.GetFirstRow(Band), Bands.GetEndRow(Band));
+		}
+
+		BandProgress.EndBand();
+	}, Bands.GetFlags());
+
+	return !BandProgress.WasAbandoned();
+}
+
+void FMinesweeperBoard::ComputeAdjacentCountsRowMajor(const int32 FirstRow, const int32 EndRow)
+{
+	using namespace MinesweeperBoard;
+
+	// Rows are word aligned and surrounded by zero border rows, so the rows above and below are
+	// plain word offsets into the bomb plane
+	for (int32 Row = FMath::Max(FirstRow, 1); Row < FMath::Min(EndRow, Height + 1); ++Row)
+	{
+		const uint64* Above = &BombPlane[(Row - 1) * RowWords];
+		const uint64* Center = Above + RowWords;
+		const uint64* Below = Center + RowWords;
+
+		for (int32 Word = 0; Word < RowWords; ++Word)
+		{
+			// Bits carried across the ends of the row only reach lane 0 of the first word and lane 63 of
+			// the last one, which are both border cells, so those can shift in zeros
+			const bool bHasPrev = Word > 0;
+			const bool bHasNext = Word + 1 < RowWords;
+
+			// Neighbour masks, bit N of each is set when that neighbour of lane N holds a bomb
+			const uint64 N = Above[Word];
+			const uint64 NW = (Above[Word] << 1) | (bHasPrev ? Above[Word - 1] >> 63 : 0);
+			const uint64 NE = (Above[Word] >> 1) | (bHasNext ? Above[Word + 1] << 63 : 0);
+			const uint64 W = (Center[Word] << 1) | (bHasPrev ? Center[Word - 1] >> 63 : 0);
+			const uint64 E = (Center[Word] >> 1) | (bHasNext ? Center[Word + 1] << 63 : 0);
+			const uint64 S = Below[Word];
+			const uint64 SW = (Below[Word] << 1) | (bHasPrev ? Below[Word - 1] >> 63 : 0);
+			const uint64 SE = (Below[Word] >> 1) | (bHasNext ? Below[Word + 1] << 63 : 0);
+
+			uint64 Bit0, Bit1, Bit2, Bit3;
+			SumNeighborMasks(NW, N, NE, W, E, SW, S, SE, Bit0, Bit1, Bit2, Bit3);
+			StoreAdjacentCounts(Row * RowWords + Word, Bit0, Bit1, Bit2, Bit3);
+		}
+	}
+}
+
+void FMinesweeperBoard::ComputeAdjacentCountsBlocked(const int32 FirstRow, const int32 EndRow)
+{
+	using namespace MinesweeperBoard;
+
+	// Each word is an 8x8 block, lane = Y * 8 + X. Neighbour masks are built by shifting the block and
+	// pulling the missing edge row or column in from the adjacent block. Blocks on the outside of the
+	// grid only ever feed border cells, so missing neighbours can be treated as empty.
+	constexpr uint64 FirstColumn = 0x0101010101010101ull;
+	constexpr uint64 LastColumn = 0x8080808080808080ull;
+
+	const auto ShiftWest = [](const uint64 Block, const uint64 Left) { return ((Block << 1) & ~FirstColumn) | ((Left >> 7) & FirstColumn); };
+	const auto ShiftEast = [](const uint64 Block, const uint64 Right) { return ((Block >> 1) & ~LastColumn) | ((Right << 7) & LastColumn); };
+	const auto ShiftNorth = [](const uint64 Block, const uint64 Up) { return (Block << 8) | (Up >> 56); };
+	const auto ShiftSouth = [](const uint64 Block, const uint64 Down) { return (Block >> 8) | (Down << 56); };
+
+	const auto BombWord = [this](const int32 BlockX, const int32 BlockY) -> uint64 {
+		if (BlockX < 0 || BlockX >= BlocksPerRow || BlockY < 0 || BlockY >= BlockRows)
+		{
+			return 0;
+		}
+		return BombPlane[BlockY * BlocksPerRow + BlockX];
+	};
+
+	for (int32 BlockY = FirstRow; BlockY < EndRow; ++BlockY)
+	{
+		for (int32 BlockX = 0; BlockX < BlocksPerRow; ++BlockX)
+		{
+			const int32 WordIndex = BlockY * BlocksPerRow + BlockX;
+
+			const uint64 Center = BombPlane[WordIndex];
+			const uint64 Left = BombWord(BlockX - 1, BlockY);
+			const uint64 Right = BombWord(BlockX + 1, BlockY);
+			const uint64 Up = BombWord(BlockX, BlockY - 1);
+			const uint64 Down = BombWord(BlockX, BlockY + 1);
+
+			// Neighbour masks, bit N of each is set when that neighbour of lane N holds a bomb
+			const uint64 W = ShiftWest(Center, Left);
+			const uint64 E = ShiftEast(Center, Right);
+			const uint64 N = ShiftNorth(Center, Up);
+			const uint64 S = ShiftSouth(Center, Down);
+			const uint64 NW = ShiftNorth(W, ShiftWest(Up, BombWord(BlockX - 1, BlockY - 1)));
+			const uint64 NE = ShiftNorth(E, ShiftEast(Up, BombWord(BlockX + 1, BlockY - 1)));
+			const uint64 SW = ShiftSouth(W, ShiftWest(Down, BombWord(BlockX - 1, BlockY + 1)));
+			const uint64 SE = ShiftSouth(E, ShiftEast(Down, BombWord(BlockX + 1, BlockY + 1)));
+
+			uint64 Bit0, Bit1, Bit2, Bit3;
+			SumNeighborMasks(NW, N, NE, W, E, SW, S, SE, Bit0, Bit1, Bit2, Bit3);
+			StoreAdjacentCounts(WordIndex, Bit0, Bit1, Bit2, Bit3);
+		}
+	}
+}
+
+void FMinesweeperBoard::StoreAdjacentCounts(const int32 WordIndex, const uint64 Bit0, const uint64 Bit1, const uint64 Bit2, const uint64 Bit3)
+{
+	// Bomb and border cells keep a count of zero, and zero counts are already stored
+	uint64 NonZero = (Bit0 | Bit1 | Bit2 | Bit3) & ~BombPlane[WordIndex] & GetPlayableMask(WordIndex);
+	const int32 WordStart = WordIndex * 64;
+
+	while (NonZero != 0)
+	{
+		const int32 Lane = static_cast<int32>(FMath::CountTrailingZeros64(NonZero));
+		const int32 Count = static_cast<int32>(((Bit0 >> Lane) & 1) | (((Bit1 >> Lane) & 1) << 1) | (((Bit2 >> Lane) & 1) << 2) | (((Bit3 >> Lane) & 1) << 3));
+		SetAdjacentBombs(WordStart + Lane, Count);
+		NonZero &= NonZero - 1;
+	}
+}
+
+bool FMinesweeperBoard::VerifyAdjacentCounts() const
+{
+	for (int32 Y = 0; Y < Height; ++Y)
+	{
+		for (int32 X = 0; X < Width; ++X)
+		{
+			const int32 CurrentIndex = GetCellIndex(X, Y);
+
+			int32 AdjacentBombs = 0;
+			if (!IsBomb(CurrentIndex))
+			{
+				for (int32 CheckY = FMath::Max(Y - 1, 0); CheckY <= FMath::Min(Y + 1, Height - 1); ++CheckY)
+				{
+					for (int32 CheckX = FMath::Max(X - 1, 0); CheckX <= FMath::Min(X + 1, Width - 1); ++CheckX)
+					{
+						AdjacentBombs += IsBomb(GetCellIndex(CheckX, CheckY)) ? 1 : 0;
+					}
+				}
+			}
+
+			if (GetAdjacentBombs(CurrentIndex) != AdjacentBombs)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+// ==== Zero regions
+
+bool FMinesweeperBoard::ComputeZeroRegions(const bool bParallel, const TFunctionRef<bool(const float)> OnProgress)
+{
+	MS_SCOPE_CYCLE_COUNTER(STAT_Minesweeper_ComputeZeroRegions);
+
+	// Union-find over zero cells, the array holds parent cell indices for now. Roots always link to the
+	// smaller index, so every parent is at or below its child and each region's root is its first cell
+	// in memory order, whatever order the links were made in.
+	ZeroRegionLabels.Init(INDEX_NONE, AdjacentCounts.Num() * 2);
+	int32* Parents = ZeroRegionLabels.GetData();
+
+	const auto FindRoot = [Parents](int32 Index) {
+		while (Parents[Index] != Index)
+		{
+			Parents[Index] = Parents[Parents[Index]];
+			Index = Parents[Index];
+		}
+		return Index;
+	};
+
+	// Links a zero cell to its zero neighbours in [MinNeighborIndex, CellIndex)
+	const auto LinkEarlierNeighbors = [&](const int32 CellIndex, const int32 MinNeighborIndex) {
+		ForEachNeighbor(CellIndex, [&](const int32 NeighborIndex) {
+			if (NeighborIndex >= CellIndex || NeighborIndex < MinNeighborIndex || Parents[NeighborIndex] == INDEX_NONE)
+				return;
+
+			const int32 Root = FindRoot(CellIndex);
+			const int32 NeighborRoot = FindRoot(NeighborIndex);
+			if (Root != NeighborRoot)
+			{
+				Parents[FMath::Max(Root, NeighborRoot)] = FMath::Min(Root, NeighborRoot);
+			}
+		});
+	};
+
+	// Each band only links cells inside itself, so bands never touch each other's parents
+	const MinesweeperBoard::FRowBands Bands(GetNumStorageRows(), GetCellsPerStorageRow(), bParallel);
+
+	// The banded union-find is about half of the pass, the serial sweeps below are the rest
+	const auto OnBandProgress = [&OnProgress](const float BandShare) { return OnProgress(BandShare * 0.5f); };
+	MinesweeperBoard::FBandProgress BandProgress(Bands.Num, OnBandProgress);
+
+	ParallelFor(Bands.Num, [&](const int32 Band) {
+		if (!BandProgress.BeginBand())
+			return;
+
+		const int32 BandFirstCell = Bands.GetFirstRow(Band) * GetCellsPerStorageRow();
+
+		ForEachTileInStorageRows(Bands.GetFirstRow(Band), Bands.GetEndRow(Band), [&](const int32 CellIndex, int32, int32) {
+			if (IsBomb(CellIndex) || GetAdjacentBombs(CellIndex) != 0)
+				return;
+
+			Parents[CellIndex] = CellIndex;
+			LinkEarlierNeighbors(CellIndex, BandFirstCell);
+		});
+
+		BandProgress.EndBand();
+	}, Bands.GetFlags());
+
+	// Half built labels must not be mistaken for regions
+	if (BandProgress.WasAbandoned() || !OnProgress(0.5f))
+	{
+		ZeroRegionLabels.Empty();
+		return false;
+	}
+
+	// Stitch the seams: only the first storage row of a band has neighbours in the band above
+	for (int32 Band = 1; Band < Bands.Num; ++Band)
+	{
+		const int32 SeamRow = Bands.GetFirstRow(Band);
+		ForEachTileInStorageRows(SeamRow, FMath::Min(SeamRow + 1, Bands.GetEndRow(Band)), [&](const int32 CellIndex, int32, int32) {
+			if (Parents[CellIndex] != INDEX_NONE)
+			{
+				LinkEarlierNeighbors(CellIndex, 0);
+			}
+		});
+	}
+
+	// Replace parents with dense region ids in place. Cells below the current one already hold ids,
+	// so a non-root cell takes the id its parent was given.
+	int32 NumRegions = 0;
+	ForEachTile([&](const int32 CellIndex, int32, int32) {
+		if (Parents[CellIndex] != INDEX_NONE)
+		{
+			Parents[CellIndex] = Parents[CellIndex] == CellIndex ? NumRegions++ : Parents[Parents[CellIndex]];
+		}
+	});
+
+	if (!OnProgress(0.75f))
+	{
+		ZeroRegionLabels.Empty();
+		return false;
+	}
+
+	// Collect the opening masks in a single sweep. Tiles arrive in memory order, so a region's cells come
+	// in increasing word order and a new pair is only needed when the word changes.
+	TArray<int32> PairRegions;
+	TArray<int32> PairWords;
+	TArray<uint64> PairMasks;
+
+	TArray<int32> LastPair;
+	LastPair.Init(INDEX_NONE, NumRegions);
+
+	const auto AddToOpening = [&](const int32 Region, const int32 CellIndex) {
+		const int32 WordIndex = CellIndex >> 6;
+		if (LastPair[Region] == INDEX_NONE || PairWords[LastPair[Region]] != WordIndex)
+		{
+			LastPair[Region] = PairRegions.Add(Region);
+			PairWords.Add(WordIndex);
+			PairMasks.Add(0);
+		}
+		PairMasks[LastPair[Region]] |= uint64(1) << (CellIndex & 63);
+	};
+
+	ForEachTile([&](const int32 CellIndex, int32, int32) {
+		// A zero tile's zero neighbours share its region, so only numbered tiles can border several openings
+		if (Parents[CellIndex] != INDEX_NONE)
+		{
+			AddToOpening(Parents[CellIndex], CellIndex);
+			return;
+		}
+
+		if (IsBomb(CellIndex))
+			return;
+
+		int32 Regions[NumNeighbors + 1];
+		const int32 NumContaining = GetZeroRegionsContaining(CellIndex, Regions);
+		for (int32 RegionSlot = 0; RegionSlot < NumContaining; ++RegionSlot)
+		{
+			AddToOpening(Regions[RegionSlot], CellIndex);
+		}
+	});
+
+	// Counting sort of the pairs by region, keeping memory order inside each region
+	ZeroRegionStarts.Init(0, NumRegions + 1);
+	for (const int32 Region : PairRegions)
+	{
+		ZeroRegionStarts[Region + 1]++;
+	}
+
+	for (int32 Region = 0; Region < NumRegions; ++Region)
+	{
+		ZeroRegionStarts[Region + 1] += ZeroRegionStarts[Region];
+	}
+
+	ZeroRegionWords.SetNumUninitialized(PairRegions.Num());
+	ZeroRegionMasks.SetNumUninitialized(PairRegions.Num());
+
+	TArray<int32>& Cursors = LastPair;
+	for (int32 Region = 0; Region < NumRegions; ++Region)
+	{
+		Cursors[Region] = ZeroRegionStarts[Region];
+	}
+
+	for (int32 Pair = 0; Pair < PairRegions.Num(); ++Pair)
+	{
+		const int32 Slot = Cursors[PairRegions[Pair]]++;
+		ZeroRegionWords[Slot] = PairWords[Pair];
+		ZeroRegionMasks[Slot] = PairMasks[Pair];
+	}
+
+	return true;
+}
+
+int32 FMinesweeperBoard::GetZeroRegionsContaining(const int32 Index, int32 (&OutRegions)[NumNeighbors + 1]) const
+{
+	if (ZeroRegionLabels.Num() == 0)
+		return 0;
+
+	int32 NumRegions = 0;
+	const auto AddRegion = [&](const int32 Region) {
+		if (Region == INDEX_NONE)
+			return;
+
+		for (int32 Slot = 0; Slot < NumRegions; ++Slot)
+		{
+			if (OutRegions[Slot] == Region)
+				return;
+		}
+		OutRegions[NumRegions++] = Region;
+	};
+
+	AddRegion(ZeroRegionLabels[Index]);
+	ForEachNeighbor(Index, [&](const int32 NeighborIndex) { AddRegion(ZeroRegionLabels[NeighborIndex]); });
+	return NumRegions;
+}
+
+int32 FMinesweeperBoard::RevealZeroRegion(const int32 Region, TArray<FMinesweeperRevealedCells>* OutRevealedCells)
+{
+	int32 NumRevealed = 0;
+	for (int32 Pair = ZeroRegionStarts[Region]; Pair < ZeroRegionStarts[Region + 1]; ++Pair)
+	{
+		const int32 WordIndex = ZeroRegionWords[Pair];
+		const uint64 NewlyRevealed = ZeroRegionMasks[Pair] & ~RevealedPlane[WordIndex];
+		RevealedPlane[WordIndex] |= NewlyRevealed;
+		NumRevealed += FMath::CountBits(NewlyRevealed);
+
+		// Openings never hold bombs, and only flag-free openings are revealed in bulk
+		if (OutRevealedCells && NewlyRevealed != 0)
+		{
+			OutRevealedCells->Emplace(WordIndex, NewlyRevealed);
+		}
+	}
+
+	return NumRevealed;
+}
+
+// ==== Layout hash
+
+uint64 FMinesweeperBoard::ComputeLayoutHash() const
+{
+	const int32 Dimensions[2] = { Width, Height };
+	uint64 Hash = CityHash64(reinterpret_cast<const char*>(Dimensions), sizeof(Dimensions));
+
+	// Hash row by row so the result does not depend on plane layout or padding
+	const int32 TileRowWords = FMath::DivideAndRoundUp(Width, 64);
+	TArray<uint64> RowBits;
+	RowBits.SetNumZeroed(TileRowWords);
+
+	for (int32 Y = 0; Y < Height; ++Y)
+	{
+		ExtractBombRow(Y, RowBits.GetData());
+		Hash = CityHash64WithSeed(reinterpret_cast<const char*>(RowBits.GetData()), TileRowWords * sizeof(uint64), Hash);
+	}
+
+	return Hash;
+}
+
+SIZE_T FMinesweeperBoard::GetAllocatedSize() const
+{
+	return PlayableRowMask.GetAllocatedSize()
+		+ BombPlane.GetAllocatedSize()
+		+ RevealedPlane.GetAllocatedSize()
+		+ FlaggedPlane.GetAllocatedSize()
+		+ AdjacentCounts.GetAllocatedSize()
+		+ ZeroRegionLabels.GetAllocatedSize()
+		+ ZeroRegionStarts.GetAllocatedSize()
+		+ ZeroRegionWords.GetAllocatedSize()
+		+ ZeroRegionMasks.GetAllocatedSize();
+}
+
+void FMinesweeperBoard::ExtractBombRow(const int32 Y, uint64* OutWords) const
+{
+	const int32 OutWordCount = FMath::DivideAndRoundUp(Width, 64);
+	const int32 PaddedY = Y + 1;
+
+	// Gather 64 padded columns starting at PaddedX, column X lives at padded column X + 1
+	const auto ReadPaddedBits = [this, PaddedY](const int32 PaddedX) -> uint64 {
+		if (Layout == EMinesweeperCellLayout::RowMajor)
+		{
+			const int32 Word = PaddedX >> 6;
+			return Word < RowWords ? BombPlane[PaddedY * RowWords + Word] : 0;
+		}
+
+		// One byte per 8x8 block along the row
+		uint64 Bits = 0;
+		const int32 FirstBlock = PaddedX >> 3;
+		const int32 RowShift = (PaddedY & 7) * 8;
+		for (int32 Block = 0; Block < 8 && FirstBlock + Block < BlocksPerRow; ++Block)
+		{
+			const uint64 BlockBits = BombPlane[(PaddedY >> 3) * BlocksPerRow + FirstBlock + Block];
+			Bits |= ((BlockBits >> RowShift) & 0xFF) << (Block * 8);
+		}
+		return Bits;
+	};
+
+	// Shift the border column out. Bits past the last column come from border cells and are already zero.
+	for (int32 Word = 0; Word < OutWordCount; ++Word)
+	{
+		OutWords[Word] = (ReadPaddedBits(Word * 64) >> 1) | (ReadPaddedBits((Word + 1) * 64) << 63);
+	}
+}
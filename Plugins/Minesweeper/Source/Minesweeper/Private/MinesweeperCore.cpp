@@ -3,30 +3,100 @@
 
 #include "MinesweeperCore.h"
 
+#include "Algo/Count.h"
+#include "HAL/IConsoleManager.h"
 #include "MinesweeperLog.h"
+#include "MinesweeperStats.h"
+#include "MinesweeperTrace.h"
+#include "Misc/Guid.h"
+
+static TAutoConsoleVariable<bool> CVarMinesweeperParallelGeneration(
+	TEXT("Minesweeper.ParallelGeneration"),
+	true,
+	TEXT("Split board generation into row bands run with ParallelFor. Boards are identical either way."));
 
 FMinesweeperCore::FMinesweeperCore()
 	: CurrentGameState(EMinesweeperGameState::NotStarted)
+	, BoardHash(0)
 	, RevealedTileCount(0)
-	, FlaggedTileCount(0) {}
+	, FlaggedTileCount(0)
+	, SafeRevealedTileCount(0)
+	, CorrectFlagCount(0)
+	, IncorrectFlagCount(0) {}
 
 FMinesweeperCore::~FMinesweeperCore()
 {
-	GameBoardTiles.Empty();
+	Board.Empty();
 }
 
 // ==== Game Management
 
-void FMinesweeperCore::InitializeGame(const FMinesweeperGameSettings& InSettings)
+namespace MinesweeperCore
+{
+	/** Share of the generation time spent placing bombs, used to scale progress reports */
+	constexpr float BombPlacementProgress = 0.4f;
+
+	/** Progress once the adjacent counts are in, the zero regions take the rest */
+	constexpr float AdjacentCountsProgress = 0.7f;
+
+	/** Bombs placed between two progress reports */
+	constexpr int32 BombsPerProgressReport = 64 * 1024;
+
+	bool ReportProgress(const FOnMinesweeperGenerationProgress& OnProgress, const float Progress)
+	{
+		return !OnProgress.IsBound() || OnProgress.Execute(Progress);
+	}
+
+	/** Sorts revealed cell masks by word and merges entries of the same word */
+	void CompactRevealedCells(TArray<FMinesweeperRevealedCells>& RevealedCells)
+	{
+		RevealedCells.Sort([](const FMinesweeperRevealedCells& A, const FMinesweeperRevealedCells& B) { return A.WordIndex < B.WordIndex; });
+
+		int32 NumMerged = 0;
+		for (int32 Entry = 0; Entry < RevealedCells.Num(); ++Entry)
+		{
+			if (NumMerged > 0 && RevealedCells[NumMerged - 1].WordIndex == RevealedCells[Entry].WordIndex)
+			{
+				RevealedCells[NumMerged - 1].CellMask |= RevealedCells[Entry].CellMask;
+			}
+			else
+			{
+				RevealedCells[NumMerged++] = RevealedCells[Entry];
+			}
+		}
+		RevealedCells.SetNum(NumMerged, EAllowShrinking::No);
+	}
+}
+
+void FMinesweeperCore::InitializeGame(const FMinesweeperGameSettings& InSettings, const FOnMinesweeperGenerationProgress& OnProgress)
 {
+	MS_SCOPE_CYCLE_COUNTER(STAT_Minesweeper_InitializeGame);
+	LLM_SCOPE_BYTAG(Minesweeper_Core);
+
 	GameSettings = InSettings;
 	GameSettings.ValidateAndClamp();
 
+	// No seed requested, roll one and keep it in the settings so this board can be regenerated
+	if (GameSettings.RandomSeed == 0)
+	{
+		GameSettings.RandomSeed = MakeRandomSeed();
+	}
+
 	ResetGame();
-	GenerateBoardTiles();
+
+#if MINESWEEPER_LOG_ENABLE
+	const double GenerationStartTime = FPlatformTime::Seconds();
+#endif
+
+	if (!GenerateBoardTiles(OnProgress))
+	{
+		MS_DISPLAY("Generation of %dx%d board abandoned", GameSettings.GridWidth, GameSettings.GridHeight);
+		ResetGame();
+		return;
+	}
 
 	CurrentGameState = EMinesweeperGameState::Active;
-	MS_DISPLAY("Game initialized with %dx%d grid and %d bombs", GameSettings.GridWidth, GameSettings.GridHeight, GameSettings.BombCount);
+	MS_DISPLAY("Game initialized with %dx%d grid and %d bombs in %.2f ms (seed %d, board hash %016llx)", GameSettings.GridWidth, GameSettings.GridHeight, GameSettings.BombCount, (FPlatformTime::Seconds() - GenerationStartTime) * 1000.0, GameSettings.RandomSeed, BoardHash);
 }
 
 void FMinesweeperCore::ResetGame()
@@ -34,83 +104,184 @@ void FMinesweeperCore::ResetGame()
 	CurrentGameState = EMinesweeperGameState::NotStarted;
 	RevealedTileCount = 0;
 	FlaggedTileCount = 0;
-	GameBoardTiles.Empty();
+	SafeRevealedTileCount = 0;
+	CorrectFlagCount = 0;
+	IncorrectFlagCount = 0;
+	BoardHash = 0;
+	Board.Empty();
+	ZeroRegionFlagCounts.Empty();
+	OpenedZeroRegions.Empty();
+}
+
+int32 FMinesweeperCore::MakeRandomSeed()
+{
+	// FMath::Rand() stops at RAND_MAX, only 32767 on some platforms. A new GUID draws on the platform's random source.
+	const int32 Seed = static_cast<int32>(GetTypeHash(FGuid::NewGuid()) & MAX_int32);
+	return Seed != 0 ? Seed : 1;
 }
 
 // ==== Tile Operations
 
-bool FMinesweeperCore::RevealTile(const int32 X, const int32 Y)
+bool FMinesweeperCore::RevealTile(const int32 X, const int32 Y, FMinesweeperChangeSet* OutChangeSet)
 {
+	MS_SCOPE_CYCLE_COUNTER(STAT_Minesweeper_RevealTile);
+	LLM_SCOPE_BYTAG(Minesweeper_Core);
+
+	if (OutChangeSet)
+	{
+		OutChangeSet->Reset(CurrentGameState);
+	}
+
 	if (!IsGameActive() || !IsValidCoordinate(X, Y))
 		return false;
 
-	FMinesweeperTile& Tile = GameBoardTiles[GetTileIndex(X, Y)];
-	if (Tile.bIsRevealed || Tile.bIsFlagged)
+	const int32 CellIndex = Board.GetCellIndex(X, Y);
+	if (Board.IsRevealed(CellIndex) || Board.IsFlagged(CellIndex))
 		return false;
 
-	Tile.bIsRevealed = true;
-	RevealedTileCount++;
+	BeginChangeSet(OutChangeSet);
 
-	MS_DISPLAY("Revealed tile at [%d, %d]", X, Y);
+#if STATS || MINESWEEPER_LOG_ENABLE
+	const int32 RevealedBefore = RevealedTileCount;
+#endif
 
-	if (Tile.bIsBomb)
+	RevealCell(CellIndex);
+	INC_DWORD_STAT_BY(STAT_Minesweeper_TilesRevealedPerClick, RevealedTileCount - RevealedBefore);
+
+#if MINESWEEPER_LOG_ENABLE
+	// Revealing a bomb is what lost the game, RevealTile() only runs on active games
+	if (CurrentGameState == EMinesweeperGameState::Lost)
 	{
-		EndGame(false);
-		return true;
+		MS_MOVE_DISPLAY("Revealed bomb at [%d, %d]", X, Y);
 	}
-
-	// Auto-reveal adjacent tiles if this tile has no adjacent bombs
-	if (Tile.AdjacentBombs == 0)
+	else if (RevealedTileCount - RevealedBefore > 1)
 	{
-		RevealAdjacentTiles(X, Y);
+		MS_MOVE_DISPLAY("Revealed tile at [%d, %d], opening %d more tiles", X, Y, RevealedTileCount - RevealedBefore - 1);
 	}
+	else
+	{
+		MS_MOVE_DISPLAY("Revealed tile at [%d, %d]", X, Y);
+	}
+#endif
 
 	CheckWinCondition();
+	FinishChangeSet();
 	return true;
 }
 
-void FMinesweeperCore::ToggleFlag(const int32 X, const int32 Y)
+void FMinesweeperCore::ToggleFlag(const int32 X, const int32 Y, FMinesweeperChangeSet* OutChangeSet)
 {
+	MS_SCOPE_CYCLE_COUNTER(STAT_Minesweeper_ToggleFlag);
+	LLM_SCOPE_BYTAG(Minesweeper_Core);
+
+	if (OutChangeSet)
+	{
+		OutChangeSet->Reset(CurrentGameState);
+	}
+
 	if (!IsGameActive() || !IsValidCoordinate(X, Y))
 		return;
 
-	FMinesweeperTile& Tile = GameBoardTiles[GetTileIndex(X, Y)];
+	const int32 CellIndex = Board.GetCellIndex(X, Y);
 
 	// Can't flag already revealed tiles
-	if (Tile.bIsRevealed)
+	if (Board.IsRevealed(CellIndex))
 		return;
 
-	if (Tile.bIsFlagged)
+	BeginChangeSet(OutChangeSet);
+
+	const bool bFlag = !Board.IsFlagged(CellIndex);
+	if (SetCellFlagged(CellIndex, bFlag))
 	{
-		// Remove flag
-		Tile.bIsFlagged = false;
-		FlaggedTileCount--;
-		MS_DISPLAY("Removed flag from tile [%d, %d]", X, Y);
+		MS_MOVE_DISPLAY("%s tile [%d, %d]", bFlag ? TEXT("Added flag to") : TEXT("Removed flag from"), X, Y);
 	}
-	else
+
+	CheckWinCondition();
+	FinishChangeSet();
+}
+
+int32 FMinesweeperCore::ApplyMoves(const TConstArrayView<FMinesweeperMove> Moves, FMinesweeperChangeSet* OutChangeSet)
+{
+	MS_SCOPE_CYCLE_COUNTER(STAT_Minesweeper_ApplyMoves);
+	LLM_SCOPE_BYTAG(Minesweeper_Core);
+
+	if (OutChangeSet)
+	{
+		OutChangeSet->Reset(CurrentGameState);
+	}
+
+	if (!IsGameActive())
+		return 0;
+
+	// Validation pass, off-board moves are dropped up front so the apply loop only deals with cells
+	BatchCellIndices.Reset(Moves.Num());
+	for (const FMinesweeperMove& Move : Moves)
 	{
-		// Add flag (only if we haven't exceeded bomb count)
-		if (FlaggedTileCount < GameSettings.BombCount)
+		BatchCellIndices.Add(IsValidCoordinate(Move.X, Move.Y) ? Board.GetCellIndex(Move.X, Move.Y) : INDEX_NONE);
+	}
+
+	BeginChangeSet(OutChangeSet);
+
+	int32 AppliedMoves = 0;
+	int32 MoveIndex = 0;
+	for (; MoveIndex < Moves.Num(); ++MoveIndex)
+	{
+		const int32 CellIndex = BatchCellIndices[MoveIndex];
+		if (CellIndex == INDEX_NONE)
+			continue;
+
+		bool bApplied = false;
+		switch (Moves[MoveIndex].Type)
+		{
+			case EMinesweeperMoveType::Reveal:
+				bApplied = !Board.IsRevealed(CellIndex) && !Board.IsFlagged(CellIndex);
+				if (bApplied)
+				{
+					RevealCell(CellIndex);
+				}
+				break;
+
+			case EMinesweeperMoveType::Flag:
+				bApplied = !Board.IsRevealed(CellIndex) && SetCellFlagged(CellIndex, true);
+				break;
+
+			case EMinesweeperMoveType::Unflag:
+				bApplied = !Board.IsRevealed(CellIndex) && SetCellFlagged(CellIndex, false);
+				break;
+
+			case EMinesweeperMoveType::Chord:
+				bApplied = ChordCell(CellIndex);
+				break;
+		}
+
+		AppliedMoves += bApplied ? 1 : 0;
+
+		// The win condition is a couple of counter compares, checking it per move stops the batch on
+		// exactly the move a player making the same moves one by one would have won with
+		if (!IsGameActive() || IsWinConditionMet())
 		{
-			Tile.bIsFlagged = true;
-			FlaggedTileCount++;
-			MS_DISPLAY("Added flag to tile [%d, %d]", X, Y);
+			++MoveIndex;
+			break;
 		}
 	}
 
 	CheckWinCondition();
+
+	MS_MOVE_DISPLAY("Applied %d of %d moves (%d off the board, %d skipped after the game ended)", AppliedMoves, Moves.Num(), Algo::Count(BatchCellIndices, INDEX_NONE), Moves.Num() - MoveIndex);
+	FinishChangeSet();
+	return AppliedMoves;
 }
 
 // ==== Tile Queries
 
-const FMinesweeperTile* FMinesweeperCore::GetTile(const int32 X, const int32 Y) const
+FMinesweeperTileProxy FMinesweeperCore::GetTile(const int32 X, const int32 Y) const
 {
 	if (!IsValidCoordinate(X, Y))
 	{
-		return nullptr;
+		return FMinesweeperTileProxy();
 	}
 
-	return &GameBoardTiles[GetTileIndex(X, Y)];
+	return FMinesweeperTileProxy(Board.GetTile(Board.GetCellIndex(X, Y)));
 }
 
 bool FMinesweeperCore::IsValidCoordinate(const int32 X, const int32 Y) const
@@ -123,6 +294,18 @@ int32 FMinesweeperCore::GetTileIndex(const int32 X, const int32 Y) const
 	return Y * GameSettings.GridWidth + X;
 }
 
+SIZE_T FMinesweeperCore::GetAllocatedSize() const
+{
+	return sizeof(*this)
+		+ Board.GetAllocatedSize()
+		+ FloodWorklist.GetAllocatedSize()
+		+ BatchCellIndices.GetAllocatedSize()
+		+ ZeroRegionFlagCounts.GetAllocatedSize()
+		+ OpenedZeroRegions.GetAllocatedSize()
+		+ DelegateChangeSet.TileChanges.GetAllocatedSize()
+		+ DelegateChangeSet.RevealedCells.GetAllocatedSize();
+}
+
 // ==== Internal Logic
 
 void FMinesweeperCore::EndGame(const bool bWon)
@@ -130,154 +313,355 @@ void FMinesweeperCore::EndGame(const bool bWon)
 	CurrentGameState = bWon ? EMinesweeperGameState::Won : EMinesweeperGameState::Lost;
 
 	// Reveal all bombs and flags for end game display
-	for (FMinesweeperTile& Tile : GameBoardTiles)
-	{
-		if (Tile.bIsBomb || Tile.bIsFlagged)
-		{
-			if (bWon)
-			{
-				Tile.bIsFlagged = true;
-			}
-			Tile.bIsRevealed = true;
-		}
-	}
+	Board.RevealBombsAndFlags(bWon, GetRecordedTileChanges());
 
+	MS_TRACE(GameEnded, INDEX_NONE, bWon ? 1 : 0);
 	MS_DISPLAY("Game ended - %s", bWon ? TEXT("Won") : TEXT("Lost"));
 }
 
 void FMinesweeperCore::CheckWinCondition()
 {
+	MS_SCOPE_CYCLE_COUNTER(STAT_Minesweeper_CheckWinCondition);
+
 	if (!IsGameActive())
 	{
 		return;
 	}
 
+	// Counters are maintained incrementally, so this stays constant time whatever the board size
+	checkSlow(CorrectFlagCount == Board.CountCorrectFlags() && IncorrectFlagCount == Board.CountIncorrectFlags());
+
+	if (IsWinConditionMet())
+	{
+		EndGame(true);
+	}
+}
+
+bool FMinesweeperCore::IsWinConditionMet() const
+{
 	const int32 TotalNonBombTiles = GameSettings.GetTotalTiles() - GameSettings.BombCount;
-	const bool bAllNonBombTilesRevealed = RevealedTileCount >= TotalNonBombTiles;
+	const bool bAllNonBombTilesRevealed = SafeRevealedTileCount >= TotalNonBombTiles;
 
 	// Check if all bombs are correctly flagged
-	int32 CorrectlyFlaggedBombs = 0;
-	bool bHasIncorrectFlag = false;
+	const bool bPerfectlyFlagged = CorrectFlagCount == GameSettings.BombCount && IncorrectFlagCount == 0;
+
+	return bAllNonBombTilesRevealed || bPerfectlyFlagged;
+}
 
-	for (const FMinesweeperTile& Tile : GameBoardTiles)
+bool FMinesweeperCore::RevealCell(const int32 CellIndex)
+{
+	const EMinesweeperTileState OldState = Board.GetTileState(CellIndex);
+	Board.SetRevealed(CellIndex, true);
+	RevealedTileCount++;
+	RecordTileChange(CellIndex, OldState);
+	MS_TRACE(TileRevealed, Board.CellToTileIndex(CellIndex), Board.IsBomb(CellIndex) ? -1 : Board.GetAdjacentBombs(CellIndex));
+
+	if (Board.IsBomb(CellIndex))
 	{
-		if (Tile.bIsBomb && Tile.bIsFlagged)
-		{
-			CorrectlyFlaggedBombs++;
-		}
-		else if (!Tile.bIsBomb && Tile.bIsFlagged)
-		{
-			bHasIncorrectFlag = true;
-			break;
-		}
+		EndGame(false);
+		return false;
 	}
 
-	const bool bPerfectlyFlagged = CorrectlyFlaggedBombs == GameSettings.BombCount && !bHasIncorrectFlag;
+	SafeRevealedTileCount++;
 
-	if (bAllNonBombTilesRevealed || bPerfectlyFlagged)
+	// Auto-reveal the surrounding region if this tile has no adjacent bombs
+	if (Board.GetAdjacentBombs(CellIndex) == 0 && !TryRevealZeroRegion(CellIndex))
 	{
-		EndGame(true);
+		FloodRevealFrom(CellIndex);
 	}
+
+	return true;
 }
 
-void FMinesweeperCore::GenerateBoardTiles()
+bool FMinesweeperCore::SetCellFlagged(const int32 CellIndex, const bool bFlagged)
 {
-	const int32 TotalTiles = GameSettings.GetTotalTiles();
-	GameBoardTiles.Empty(TotalTiles);
-	GameBoardTiles.SetNum(TotalTiles);
+	if (Board.IsFlagged(CellIndex) == bFlagged)
+		return false;
+
+	// Flags are limited to the bomb count
+	if (bFlagged && FlaggedTileCount >= GameSettings.BombCount)
+		return false;
+
+	const EMinesweeperTileState OldState = Board.GetTileState(CellIndex);
+	const int32 Delta = bFlagged ? 1 : -1;
 
-	// Initialize all tiles
-	for (FMinesweeperTile& Tile : GameBoardTiles)
+	Board.SetFlagged(CellIndex, bFlagged);
+	UpdateZeroRegionFlagCounts(CellIndex, Delta);
+	RecordTileChange(CellIndex, OldState);
+	MS_TRACE(TileFlagged, Board.CellToTileIndex(CellIndex), bFlagged ? 1 : 0);
+
+	FlaggedTileCount += Delta;
+	if (Board.IsBomb(CellIndex))
+	{
+		CorrectFlagCount += Delta;
+	}
+	else
 	{
-		Tile = FMinesweeperTile();
+		IncorrectFlagCount += Delta;
 	}
 
-	PlaceBombsRandomly();
-	CalculateAdjacentBombs();
+	return true;
+}
+
+bool FMinesweeperCore::ChordCell(const int32 CellIndex)
+{
+	// Only a revealed number whose flags already account for all its bombs can be chorded
+	if (!Board.IsRevealed(CellIndex) || Board.IsBomb(CellIndex) || Board.GetAdjacentBombs(CellIndex) == 0)
+		return false;
+
+	int32 AdjacentFlags = 0;
+	Board.ForEachNeighbor(CellIndex, [this, &AdjacentFlags](const int32 NeighborCellIndex) {
+		AdjacentFlags += Board.IsFlagged(NeighborCellIndex) ? 1 : 0;
+	});
+
+	if (AdjacentFlags != Board.GetAdjacentBombs(CellIndex))
+		return false;
+
+	// Border cells are permanently revealed, and neighbours opened by an earlier neighbour's flood are skipped
+	int32 NumRevealed = 0;
+	Board.ForEachNeighbor(CellIndex, [this, &NumRevealed](const int32 NeighborCellIndex) {
+		if (!IsGameActive() || Board.IsRevealed(NeighborCellIndex) || Board.IsFlagged(NeighborCellIndex))
+			return;
+
+		RevealCell(NeighborCellIndex);
+		++NumRevealed;
+	});
+
+	MS_TRACE(TileChorded, Board.CellToTileIndex(CellIndex), NumRevealed);
+	return NumRevealed > 0;
 }
 
-void FMinesweeperCore::PlaceBombsRandomly()
+bool FMinesweeperCore::GenerateBoardTiles(const FOnMinesweeperGenerationProgress& OnProgress)
 {
-	TArray<int32> AvailableIndices;
-	AvailableIndices.Reserve(GameBoardTiles.Num());
+	using namespace MinesweeperCore;
+
+	// Board storage starts out cleared
+	Board.Initialize(GameSettings.GridWidth, GameSettings.GridHeight, GameSettings.CellLayout);
+
+	// Bomb placement stays serial, Floyd's sampling is a single random sequence and that is what keeps a
+	// seed's layout stable. The passes after it are split into row bands.
+	const bool bParallel = CVarMinesweeperParallelGeneration.GetValueOnAnyThread();
+
+	if (!PlaceBombsRandomly(OnProgress))
+		return false;
 
-	for (int32 i = 0; i < GameBoardTiles.Num(); ++i)
+	if (!CalculateAdjacentBombs(bParallel, OnProgress))
+		return false;
+
+	BoardHash = Board.ComputeLayoutHash();
+
+	if (!ReportProgress(OnProgress, AdjacentCountsProgress))
+		return false;
+
+	// Openings never change once the bombs are placed, so label them once here and let clicks reveal them in bulk
+	if (Board.GetNumTiles() <= ZeroRegionMaxTiles)
 	{
-		AvailableIndices.Add(i);
+		const bool bCompleted = Board.ComputeZeroRegions(bParallel, [&OnProgress](const float PassProgress) {
+			return ReportProgress(OnProgress, FMath::Lerp(AdjacentCountsProgress, 1.0f, PassProgress));
+		});
+		if (!bCompleted)
+			return false;
+
+		ZeroRegionFlagCounts.Init(0, Board.GetNumZeroRegions());
+		OpenedZeroRegions.Init(false, Board.GetNumZeroRegions());
 	}
 
+	return ReportProgress(OnProgress, 1.0f);
+}
+
+bool FMinesweeperCore::PlaceBombsRandomly(const FOnMinesweeperGenerationProgress& OnProgress)
+{
+	MS_SCOPE_CYCLE_COUNTER(STAT_Minesweeper_PlaceBombs);
+
+	using namespace MinesweeperCore;
+
+	const int32 TotalTiles = Board.GetNumTiles();
+
 	// Ensure bomb count doesn't exceed available tiles
-	const int32 BombsToPlace = FMath::Min(GameSettings.BombCount, GameBoardTiles.Num() - 1);
-	for (int32 i = 0; i < BombsToPlace; ++i)
-	{
-		if (AvailableIndices.Num() == 0)
-			break;
+	const int32 BombsToPlace = FMath::Min(GameSettings.BombCount, TotalTiles - 1);
 
-		const int32 RandomIndex = FMath::RandRange(0, AvailableIndices.Num() - 1);
-		const int32 BoardIndex = AvailableIndices[RandomIndex];
+	// Floyd's sampling: picks a uniform random set of tiles in O(BombsToPlace), using the bomb plane itself
+	// as the membership set so no index array over the whole board is needed
+	FRandomStream RandomStream(GameSettings.RandomSeed);
 
-		GameBoardTiles[BoardIndex].bIsBomb = true;
-		AvailableIndices.RemoveAt(RandomIndex);
+	for (int32 Candidate = TotalTiles - BombsToPlace; Candidate < TotalTiles; ++Candidate)
+	{
+		// Integer range mapping keeps placement identical on every platform and avoids the float precision loss of RandRange on huge boards
+		const int32 RandomIndex = static_cast<int32>((static_cast<uint64>(RandomStream.GetUnsignedInt()) * static_cast<uint64>(Candidate + 1)) >> 32);
+		const int32 PickedTile = Board.IsBomb(Board.TileToCellIndex(RandomIndex)) ? Candidate : RandomIndex;
+		Board.SetBomb(Board.TileToCellIndex(PickedTile), true);
+
+		const int32 BombsPlaced = Candidate - (TotalTiles - BombsToPlace) + 1;
+		if (BombsPlaced % BombsPerProgressReport == 0 && !ReportProgress(OnProgress, BombPlacementProgress * BombsPlaced / BombsToPlace))
+			return false;
 	}
+
+	return ReportProgress(OnProgress, BombPlacementProgress);
 }
 
-void FMinesweeperCore::CalculateAdjacentBombs()
+bool FMinesweeperCore::CalculateAdjacentBombs(const bool bParallel, const FOnMinesweeperGenerationProgress& OnProgress)
 {
-	for (int32 Y = 0; Y < GameSettings.GridHeight; ++Y)
+	using namespace MinesweeperCore;
+
+	// Word-wide kernel, cross-checked against the per-tile 3x3 scan in slow-check builds
+	const bool bCompleted = Board.ComputeAdjacentCounts(bParallel, [&OnProgress](const float PassProgress) {
+		return ReportProgress(OnProgress, FMath::Lerp(BombPlacementProgress, AdjacentCountsProgress, PassProgress));
+	});
+	checkSlow(!bCompleted || Board.VerifyAdjacentCounts());
+	return bCompleted;
+}
+
+void FMinesweeperCore::FloodRevealFrom(const int32 StartCellIndex)
+{
+	MS_SCOPE_CYCLE_COUNTER(STAT_Minesweeper_FloodReveal);
+
+	// Breadth-first walk over an explicit worklist instead of recursing through RevealTile, so the
+	// depth of an opening no longer maps to stack depth. Only zero tiles are queued, since those are
+	// the only ones whose neighbours get revealed. The revealed plane doubles as the visited set:
+	// a tile is marked revealed the moment it is reached, so there is no per-click bitmap to clear.
+	// Border cells are permanently revealed, so the neighbour walk needs no bounds checks.
+
+	FloodWorklist.Reset();
+	FloodWorklist.Add(StartCellIndex);
+
+	// Zero tiles only connect to zero tiles of the same region, so this flood stays inside one region
+	const int32 StartRegion = Board.GetZeroRegion(StartCellIndex);
+	if (StartRegion != INDEX_NONE)
+	{
+		OpenedZeroRegions[StartRegion] = true;
+	}
+
+#if STATS
+	const int32 RevealedBeforeFlood = RevealedTileCount;
+#endif
+
+	int32 Head = 0;
+	while (Head < FloodWorklist.Num())
 	{
-		for (int32 X = 0; X < GameSettings.GridWidth; ++X)
+		// Drop the consumed front of the worklist now and then, so memory follows the size of the
+		// flood frontier rather than the size of the whole opening
+		if (Head >= FloodWorklistCompactThreshold && Head * 2 >= FloodWorklist.Num())
 		{
-			FMinesweeperTile& CurrentTile = GameBoardTiles[GetTileIndex(X, Y)];
-			if (CurrentTile.bIsBomb)
-			{
-				continue;
-			}
+			FloodWorklist.RemoveAt(0, Head, EAllowShrinking::No);
+			Head = 0;
+		}
+
+		const int32 CurrentCellIndex = FloodWorklist[Head++];
+
+		Board.ForEachNeighbor(CurrentCellIndex, [this](const int32 NeighborCellIndex) {
+			if (Board.IsRevealed(NeighborCellIndex) || Board.IsFlagged(NeighborCellIndex))
+				return;
 
-			int32 AdjacentBombs = 0;
+			// Neighbours of a zero tile can never be bombs
+			Board.SetRevealed(NeighborCellIndex, true);
+			RevealedTileCount++;
+			SafeRevealedTileCount++;
 
-			// Check all 8 adjacent tiles
-			for (int32 DY = -1; DY <= 1; ++DY)
+			RecordRevealedCell(NeighborCellIndex);
+			MS_TRACE(TileFloodRevealed, Board.CellToTileIndex(NeighborCellIndex), Board.GetAdjacentBombs(NeighborCellIndex));
+
+			if (Board.GetAdjacentBombs(NeighborCellIndex) == 0)
 			{
-				for (int32 DX = -1; DX <= 1; ++DX)
-				{
-					if (DX == 0 && DY == 0)
-						continue;
-
-					const int32 CheckX = X + DX;
-					const int32 CheckY = Y + DY;
-
-					if (IsValidCoordinate(CheckX, CheckY))
-					{
-						if (GameBoardTiles[GetTileIndex(CheckX, CheckY)].bIsBomb)
-						{
-							AdjacentBombs++;
-						}
-					}
-				}
+				FloodWorklist.Add(NeighborCellIndex);
 			}
+		});
+	}
 
-			CurrentTile.AdjacentBombs = AdjacentBombs;
-		}
+	if (TArray<FMinesweeperRevealedCells>* RevealedCells = GetRecordedRevealedCells())
+	{
+		MinesweeperCore::CompactRevealedCells(*RevealedCells);
 	}
+
+	INC_DWORD_STAT_BY(STAT_Minesweeper_FloodSize, RevealedTileCount - RevealedBeforeFlood);
+}
+
+bool FMinesweeperCore::TryRevealZeroRegion(const int32 CellIndex)
+{
+	MS_SCOPE_CYCLE_COUNTER(STAT_Minesweeper_RevealZeroRegion);
+
+	// The precomputed opening matches what a flood would reveal only while no flag blocks it and no
+	// earlier flood has opened part of it
+	const int32 Region = Board.GetZeroRegion(CellIndex);
+	if (Region == INDEX_NONE || ZeroRegionFlagCounts[Region] > 0 || OpenedZeroRegions[Region])
+		return false;
+
+	OpenedZeroRegions[Region] = true;
+
+	const int32 NumRevealed = Board.RevealZeroRegion(Region, GetRecordedRevealedCells());
+	RevealedTileCount += NumRevealed;
+	SafeRevealedTileCount += NumRevealed;
+	INC_DWORD_STAT_BY(STAT_Minesweeper_FloodSize, NumRevealed);
+	MS_TRACE(ZeroRegionRevealed, Board.CellToTileIndex(CellIndex), NumRevealed);
+	return true;
 }
 
-void FMinesweeperCore::RevealAdjacentTiles(const int32 X, const int32 Y)
+void FMinesweeperCore::UpdateZeroRegionFlagCounts(const int32 CellIndex, const int32 Delta)
 {
-	// Check all 8 adjacent tiles
-	for (int32 DY = -1; DY <= 1; ++DY)
+	int32 Regions[FMinesweeperBoard::NumNeighbors + 1];
+	const int32 NumRegions = Board.GetZeroRegionsContaining(CellIndex, Regions);
+
+	for (int32 RegionSlot = 0; RegionSlot < NumRegions; ++RegionSlot)
 	{
-		for (int32 DX = -1; DX <= 1; ++DX)
-		{
-			if (DX == 0 && DY == 0)
-				continue;
+		ZeroRegionFlagCounts[Regions[RegionSlot]] += Delta;
+	}
+}
 
-			const int32 CheckX = X + DX;
-			const int32 CheckY = Y + DY;
+// ==== Change sets
 
-			if (IsValidCoordinate(CheckX, CheckY))
-			{
-				RevealTile(CheckX, CheckY);
-			}
+void FMinesweeperCore::BeginChangeSet(FMinesweeperChangeSet* OutChangeSet)
+{
+	ActiveChangeSet = OutChangeSet ? OutChangeSet : (ChangeSetDelegate.IsBound() ? &DelegateChangeSet : nullptr);
+	if (ActiveChangeSet)
+	{
+		ActiveChangeSet->Reset(CurrentGameState);
+		RevealedCellsCompactAt = RevealedCellsCompactThreshold;
+	}
+}
+
+void FMinesweeperCore::FinishChangeSet()
+{
+	if (ActiveChangeSet)
+	{
+		ActiveChangeSet->NewGameState = CurrentGameState;
+		if (!ActiveChangeSet->IsEmpty())
+		{
+			ChangeSetDelegate.Broadcast(*ActiveChangeSet);
 		}
 	}
+
+	ActiveChangeSet = nullptr;
+}
+
+void FMinesweeperCore::RecordTileChange(const int32 CellIndex, const EMinesweeperTileState OldState)
+{
+	if (ActiveChangeSet)
+	{
+		ActiveChangeSet->TileChanges.Emplace(Board.CellToTileIndex(CellIndex), OldState, Board.GetTileState(CellIndex));
+	}
+}
+
+void FMinesweeperCore::RecordRevealedCell(const int32 CellIndex)
+{
+	if (!ActiveChangeSet)
+		return;
+
+	TArray<FMinesweeperRevealedCells>& RevealedCells = ActiveChangeSet->RevealedCells;
+	const int32 WordIndex = CellIndex >> 6;
+	const uint64 CellBit = uint64(1) << (CellIndex & 63);
+
+	if (RevealedCells.Num() > 0 && RevealedCells.Last().WordIndex == WordIndex)
+	{
+		RevealedCells.Last().CellMask |= CellBit;
+		return;
+	}
+
+	// The flood front spans a few rows, so entries alternate between a handful of words. Merging
+	// them whenever the list doubles keeps it close to one entry per touched word.
+	if (RevealedCells.Num() >= RevealedCellsCompactAt)
+	{
+		MinesweeperCore::CompactRevealedCells(RevealedCells);
+		RevealedCellsCompactAt = FMath::Max(RevealedCells.Num() * 2, RevealedCellsCompactThreshold);
+	}
+
+	RevealedCells.Emplace(WordIndex, CellBit);
 }
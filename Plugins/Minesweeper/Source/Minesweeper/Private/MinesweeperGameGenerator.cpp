@@ -0,0 +1,79 @@
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "MinesweeperGameGenerator.h"
+
+#include "MinesweeperLog.h"
+#include "Tasks/Task.h"
+
+#include <atomic>
+
+/** State shared between the game thread and the task building one game */
+struct FMinesweeperGameGenerator::FGenerationJob
+{
+	/** Settings the game was requested for, before any seed was rolled */
+	FMinesweeperGameSettings RequestedSettings;
+
+	/** Only touched by the task until bCompleted is set */
+	TSharedPtr<FMinesweeperCore> Core;
+
+	std::atomic<float> Progress = 0.0f;
+	std::atomic<bool> bCompleted = false;
+	std::atomic<bool> bCancelled = false;
+};
+
+FMinesweeperGameGenerator::~FMinesweeperGameGenerator()
+{
+	CancelCurrentJob();
+}
+
+void FMinesweeperGameGenerator::Prefetch(const FMinesweeperGameSettings& InSettings)
+{
+	if (CurrentJob.IsValid() && CurrentJob->RequestedSettings == InSettings)
+		return;
+
+	CancelCurrentJob();
+
+	TSharedPtr<FGenerationJob> Job = MakeShared<FGenerationJob>();
+	Job->RequestedSettings = InSettings;
+	Job->Core = MakeShared<FMinesweeperCore>();
+	CurrentJob = Job;
+
+	// An unseeded request is seeded by the core on the worker, FMinesweeperCore::MakeRandomSeed is thread safe
+	// The task owns a reference to the job, so it can outlive the generator and simply drop its result
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [Job, TaskSettings = InSettings]() {
+		const FOnMinesweeperGenerationProgress OnProgress = FOnMinesweeperGenerationProgress::CreateLambda([&Job](const float Progress) {
+			Job->Progress = Progress;
+			return !Job->bCancelled;
+		});
+
+		Job->Core->InitializeGame(TaskSettings, OnProgress);
+		Job->bCompleted = true;
+	});
+
+	MS_DISPLAY("Started generating a %dx%d board with %d bombs in the background", InSettings.GridWidth, InSettings.GridHeight, InSettings.BombCount);
+}
+
+TSharedPtr<FMinesweeperCore> FMinesweeperGameGenerator::TakeReadyGame(const FMinesweeperGameSettings& InSettings)
+{
+	if (!CurrentJob.IsValid() || !CurrentJob->bCompleted || CurrentJob->RequestedSettings != InSettings)
+		return nullptr;
+
+	TSharedPtr<FMinesweeperCore> ReadyCore = MoveTemp(CurrentJob->Core);
+	CurrentJob.Reset();
+	return ReadyCore;
+}
+
+float FMinesweeperGameGenerator::GetProgress() const
+{
+	return CurrentJob.IsValid() ? CurrentJob->Progress.load() : 0.0f;
+}
+
+void FMinesweeperGameGenerator::CancelCurrentJob()
+{
+	if (CurrentJob.IsValid())
+	{
+		CurrentJob->bCancelled = true;
+		CurrentJob.Reset();
+	}
+}
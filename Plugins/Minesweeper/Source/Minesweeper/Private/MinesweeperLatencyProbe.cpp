@@ -0,0 +1,188 @@
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "MinesweeperLatencyProbe.h"
+
+#include "HAL/IConsoleManager.h"
+#include "MinesweeperLog.h"
+
+bool FMinesweeperLatencyProbe::bEnabled = false;
+FMinesweeperLatencyProbe::EStage FMinesweeperLatencyProbe::Stage = FMinesweeperLatencyProbe::EStage::Idle;
+
+namespace MinesweeperLatencyProbe
+{
+	/** Samples of one operation on one board size, in milliseconds from the input */
+	struct FSeries
+	{
+		EMinesweeperLatencyOperation Operation = EMinesweeperLatencyOperation::Reveal;
+		int32 BoardWidth = 0;
+		int32 BoardHeight = 0;
+
+		/** Total samples recorded, the arrays hold the last MaxSamplesPerSeries of them */
+		int32 NumRecorded = 0;
+		TArray<float> CoreMs;
+		TArray<float> PaintMs;
+	};
+
+	TArray<FSeries> Series;
+
+	/** Interaction being followed */
+	EMinesweeperLatencyOperation PendingOperation = EMinesweeperLatencyOperation::Reveal;
+	int32 PendingBoardWidth = 0;
+	int32 PendingBoardHeight = 0;
+	uint64 InputCycles = 0;
+	uint64 CoreFinishedCycles = 0;
+
+	FSeries& FindOrAddSeries(const EMinesweeperLatencyOperation Operation, const int32 BoardWidth, const int32 BoardHeight)
+	{
+		for (FSeries& Existing : Series)
+		{
+			if (Existing.Operation == Operation && Existing.BoardWidth == BoardWidth && Existing.BoardHeight == BoardHeight)
+				return Existing;
+		}
+
+		FSeries& NewSeries = Series.AddDefaulted_GetRef();
+		NewSeries.Operation = Operation;
+		NewSeries.BoardWidth = BoardWidth;
+		NewSeries.BoardHeight = BoardHeight;
+		return NewSeries;
+	}
+
+	/** Nearest-rank percentile, sorts Samples */
+	float GetPercentile(TArray<float>& Samples, const float Percentile)
+	{
+		if (Samples.IsEmpty())
+			return 0.0f;
+
+		Samples.Sort();
+		const int32 Rank = FMath::CeilToInt(Percentile / 100.0f * Samples.Num());
+		return Samples[FMath::Clamp(Rank - 1, 0, Samples.Num() - 1)];
+	}
+}
+
+void FMinesweeperLatencyProbe::SetEnabled(const bool bInEnabled)
+{
+	bEnabled = bInEnabled;
+	Stage = EStage::Idle;
+}
+
+void FMinesweeperLatencyProbe::BeginInteractionImpl(const EMinesweeperLatencyOperation Operation)
+{
+	using namespace MinesweeperLatencyProbe;
+
+	PendingOperation = Operation;
+	InputCycles = FPlatformTime::Cycles64();
+	Stage = EStage::Input;
+}
+
+void FMinesweeperLatencyProbe::MarkCoreFinishedImpl(const int32 BoardWidth, const int32 BoardHeight)
+{
+	using namespace MinesweeperLatencyProbe;
+
+	PendingBoardWidth = BoardWidth;
+	PendingBoardHeight = BoardHeight;
+	CoreFinishedCycles = FPlatformTime::Cycles64();
+	Stage = EStage::CoreFinished;
+}
+
+void FMinesweeperLatencyProbe::MarkPaintedImpl()
+{
+	using namespace MinesweeperLatencyProbe;
+
+	const uint64 PaintCycles = FPlatformTime::Cycles64();
+	Stage = EStage::Idle;
+
+	FSeries& Target = FindOrAddSeries(PendingOperation, PendingBoardWidth, PendingBoardHeight);
+	const float CoreMs = static_cast<float>(FPlatformTime::ToMilliseconds64(CoreFinishedCycles - InputCycles));
+	const float PaintMs = static_cast<float>(FPlatformTime::ToMilliseconds64(PaintCycles - InputCycles));
+
+	if (Target.CoreMs.Num() < MaxSamplesPerSeries)
+	{
+		Target.CoreMs.Add(CoreMs);
+		Target.PaintMs.Add(PaintMs);
+	}
+	else
+	{
+		Target.CoreMs[Target.NumRecorded % MaxSamplesPerSeries] = CoreMs;
+		Target.PaintMs[Target.NumRecorded % MaxSamplesPerSeries] = PaintMs;
+	}
+	++Target.NumRecorded;
+}
+
+void FMinesweeperLatencyProbe::LogReport()
+{
+	using namespace MinesweeperLatencyProbe;
+
+	if (Series.IsEmpty())
+	{
+		MS_DISPLAY("No latency samples%s", bEnabled ? TEXT("") : TEXT(", enable the probe with Minesweeper.LatencyProbe 1"));
+		return;
+	}
+
+	// Small boards first, then by operation
+	Series.Sort([](const FSeries& A, const FSeries& B) {
+		const int64 TilesA = int64(A.BoardWidth) * A.BoardHeight;
+		const int64 TilesB = int64(B.BoardWidth) * B.BoardHeight;
+		return TilesA != TilesB ? TilesA < TilesB : A.Operation < B.Operation;
+	});
+
+	MS_DISPLAY("Minesweeper input latency in ms, input to core finished | input to first paint");
+	MS_DISPLAY("  %-7s %-11s %7s   %7s %7s %7s | %7s %7s %7s", TEXT("Op"), TEXT("Board"), TEXT("Samples"), TEXT("p50"), TEXT("p95"), TEXT("p99"), TEXT("p50"), TEXT("p95"), TEXT("p99"));
+	for (const FSeries& Entry : Series)
+	{
+		TArray<float> CoreMs = Entry.CoreMs;
+		TArray<float> PaintMs = Entry.PaintMs;
+		const FString Board = FString::Printf(TEXT("%dx%d"), Entry.BoardWidth, Entry.BoardHeight);
+
+		MS_DISPLAY("  %-7s %-11s %7d   %7.2f %7.2f %7.2f | %7.2f %7.2f %7.2f",
+			GetOperationName(Entry.Operation), *Board, Entry.NumRecorded,
+			GetPercentile(CoreMs, 50.0f), GetPercentile(CoreMs, 95.0f), GetPercentile(CoreMs, 99.0f),
+			GetPercentile(PaintMs, 50.0f), GetPercentile(PaintMs, 95.0f), GetPercentile(PaintMs, 99.0f));
+	}
+}
+
+void FMinesweeperLatencyProbe::Reset()
+{
+	MinesweeperLatencyProbe::Series.Empty();
+	Stage = EStage::Idle;
+}
+
+const TCHAR* FMinesweeperLatencyProbe::GetOperationName(const EMinesweeperLatencyOperation Operation)
+{
+	switch (Operation)
+	{
+		case EMinesweeperLatencyOperation::Reveal:
+			return TEXT("Reveal");
+		case EMinesweeperLatencyOperation::Flag:
+			return TEXT("Flag");
+		default:
+			return TEXT("Unknown");
+	}
+}
+
+namespace MinesweeperLatencyProbe
+{
+	static TAutoConsoleVariable<bool> CVarMinesweeperLatencyProbe(
+		TEXT("Minesweeper.LatencyProbe"),
+		false,
+		TEXT("Time tile interactions from the click to the first paint showing their result, reported with Minesweeper.LatencyReport."),
+		FConsoleVariableDelegate::CreateLambda([](IConsoleVariable* Variable) {
+			FMinesweeperLatencyProbe::SetEnabled(Variable->GetBool());
+		}));
+
+	void LatencyReport(const TArray<FString>& Args)
+	{
+		FMinesweeperLatencyProbe::LogReport();
+
+		if (Args.IsValidIndex(0) && Args[0] == TEXT("reset"))
+		{
+			FMinesweeperLatencyProbe::Reset();
+			MS_DISPLAY("Latency samples cleared");
+		}
+	}
+
+	static FAutoConsoleCommand LatencyReportCommand(
+		TEXT("Minesweeper.LatencyReport"),
+		TEXT("Logs p50/p95/p99 input latency per operation and board size. Args: [reset] clears the samples after logging them"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&LatencyReport));
+}
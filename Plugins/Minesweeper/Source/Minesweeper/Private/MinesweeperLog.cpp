@@ -3,3 +3,4 @@
 #include "MinesweeperLog.h"
 
 DEFINE_LOG_CATEGORY(LogMinesweeper);
+DEFINE_LOG_CATEGORY(LogMinesweeperMoves);
@@ -0,0 +1,30 @@
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MinesweeperStats.h"
+
+UE_TRACE_CHANNEL_DEFINE(MinesweeperChannel);
+
+LLM_DEFINE_TAG(Minesweeper_Core);
+LLM_DEFINE_TAG(Minesweeper_UI);
+
+DEFINE_STAT(STAT_Minesweeper_InitializeGame);
+DEFINE_STAT(STAT_Minesweeper_PlaceBombs);
+DEFINE_STAT(STAT_Minesweeper_ComputeAdjacentCounts);
+DEFINE_STAT(STAT_Minesweeper_ComputeZeroRegions);
+DEFINE_STAT(STAT_Minesweeper_RevealTile);
+DEFINE_STAT(STAT_Minesweeper_ToggleFlag);
+DEFINE_STAT(STAT_Minesweeper_ApplyMoves);
+DEFINE_STAT(STAT_Minesweeper_FloodReveal);
+DEFINE_STAT(STAT_Minesweeper_RevealZeroRegion);
+DEFINE_STAT(STAT_Minesweeper_CheckWinCondition);
+
+DEFINE_STAT(STAT_Minesweeper_RefreshGameBoardUI);
+DEFINE_STAT(STAT_Minesweeper_ApplyTileChangesToView);
+DEFINE_STAT(STAT_Minesweeper_UpdateTileButton);
+DEFINE_STAT(STAT_Minesweeper_PaintBoard);
+DEFINE_STAT(STAT_Minesweeper_RefreshLevelOfDetail);
+
+DEFINE_STAT(STAT_Minesweeper_TilesRevealedPerClick);
+DEFINE_STAT(STAT_Minesweeper_FloodSize);
+DEFINE_STAT(STAT_Minesweeper_TilesPainted);
+DEFINE_STAT(STAT_Minesweeper_TileWidgetsAlive);
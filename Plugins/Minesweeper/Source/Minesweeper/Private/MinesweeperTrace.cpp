@@ -0,0 +1,97 @@
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "MinesweeperTrace.h"
+
+#include "HAL/IConsoleManager.h"
+#include "MinesweeperLog.h"
+
+std::atomic<bool> FMinesweeperTrace::bEnabled = false;
+std::atomic<uint64> FMinesweeperTrace::NextRecord = 0;
+FMinesweeperTraceRecord* FMinesweeperTrace::Records = nullptr;
+
+void FMinesweeperTrace::SetEnabled(const bool bInEnabled)
+{
+#if MINESWEEPER_TRACE_ENABLE
+	// Allocated once and never freed, recording must not race with the buffer going away
+	if (bInEnabled && Records == nullptr)
+	{
+		Records = new FMinesweeperTraceRecord[Capacity];
+	}
+
+	bEnabled = bInEnabled;
+#else
+	if (bInEnabled)
+	{
+		MS_WARNING("The Minesweeper trace is compiled out of this build (MINESWEEPER_TRACE_ENABLE=0)");
+	}
+#endif
+}
+
+void FMinesweeperTrace::GetRecentRecords(const int32 MaxRecords, TArray<FMinesweeperTraceRecord>& OutRecords)
+{
+	OutRecords.Reset();
+	if (Records == nullptr)
+		return;
+
+	const uint64 EndRecord = NextRecord.load();
+	const uint64 NumRecords = FMath::Min<uint64>(FMath::Min<uint64>(EndRecord, Capacity), FMath::Max(MaxRecords, 0));
+
+	OutRecords.Reserve(static_cast<int32>(NumRecords));
+	for (uint64 Record = EndRecord - NumRecords; Record < EndRecord; ++Record)
+	{
+		OutRecords.Add(Records[Record & (Capacity - 1)]);
+	}
+}
+
+const TCHAR* FMinesweeperTrace::GetEventName(const EMinesweeperTraceEvent Event)
+{
+	switch (Event)
+	{
+		case EMinesweeperTraceEvent::TileRevealed:
+			return TEXT("TileRevealed");
+		case EMinesweeperTraceEvent::TileFloodRevealed:
+			return TEXT("TileFloodRevealed");
+		case EMinesweeperTraceEvent::ZeroRegionRevealed:
+			return TEXT("ZeroRegionRevealed");
+		case EMinesweeperTraceEvent::TileFlagged:
+			return TEXT("TileFlagged");
+		case EMinesweeperTraceEvent::TileChorded:
+			return TEXT("TileChorded");
+		case EMinesweeperTraceEvent::GameEnded:
+			return TEXT("GameEnded");
+		default:
+			return TEXT("Unknown");
+	}
+}
+
+namespace MinesweeperTrace
+{
+	static TAutoConsoleVariable<bool> CVarMinesweeperTrace(
+		TEXT("Minesweeper.Trace"),
+		false,
+		TEXT("Record per-tile game events into a binary ring buffer, dumped with Minesweeper.DumpTrace."),
+		FConsoleVariableDelegate::CreateLambda([](IConsoleVariable* Variable) {
+			FMinesweeperTrace::SetEnabled(Variable->GetBool());
+		}));
+
+	void DumpTrace(const TArray<FString>& Args)
+	{
+		const int32 MaxRecords = Args.IsValidIndex(0) ? FCString::Atoi(*Args[0]) : 100;
+
+		TArray<FMinesweeperTraceRecord> Records;
+		FMinesweeperTrace::GetRecentRecords(MaxRecords, Records);
+
+		MS_DISPLAY("Last %d Minesweeper trace events, microseconds relative to the first", Records.Num());
+		for (const FMinesweeperTraceRecord& Record : Records)
+		{
+			const double Microseconds = FPlatformTime::ToMilliseconds64(Record.Cycles - Records[0].Cycles) * 1000.0;
+			MS_DISPLAY("  %12.1f %-20s tile %10d value %d", Microseconds, FMinesweeperTrace::GetEventName(Record.Event), Record.TileIndex, Record.Value);
+		}
+	}
+
+	static FAutoConsoleCommand DumpTraceCommand(
+		TEXT("Minesweeper.DumpTrace"),
+		TEXT("Logs the most recent Minesweeper trace events. Args: [Count=100]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&DumpTrace));
+}
@@ -0,0 +1,195 @@
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Tests/MinesweeperBenchmarkReport.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Dom/JsonObject.h"
+#include "HAL/IConsoleManager.h"
+#include "Interfaces/IPluginManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+static TAutoConsoleVariable<float> CVarMinesweeperBenchmarkRegressionThreshold(
+	TEXT("Minesweeper.Benchmark.RegressionThreshold"),
+	0.25f,
+	TEXT("Slowdown against the recorded baseline above which a Minesweeper benchmark fails, 0.25 is 25% slower."));
+
+static TAutoConsoleVariable<bool> CVarMinesweeperBenchmarkUpdateBaseline(
+	TEXT("Minesweeper.Benchmark.UpdateBaseline"),
+	false,
+	TEXT("Write the results of Minesweeper benchmarks over their recorded baselines instead of comparing against them."));
+
+FMinesweeperBenchmarkReport::FMinesweeperBenchmarkReport(const FString& InSuiteName)
+	: SuiteName(InSuiteName) {}
+
+void FMinesweeperBenchmarkReport::Add(const FString& Metric, const FString& Case, TArray<double> SampleSeconds)
+{
+	if (SampleSeconds.IsEmpty())
+		return;
+
+	// The median shrugs off the odd run that got descheduled
+	SampleSeconds.Sort();
+
+	FMinesweeperBenchmarkResult& Result = Results.AddDefaulted_GetRef();
+	Result.Metric = Metric;
+	Result.Case = Case;
+	Result.Microseconds = SampleSeconds[SampleSeconds.Num() / 2] * 1000000.0;
+	Result.Samples = SampleSeconds.Num();
+}
+
+void FMinesweeperBenchmarkReport::Finish(FAutomationTestBase& Test) const
+{
+	const FString OutputDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Minesweeper"), TEXT("Benchmarks"));
+	const FString CsvPath = FPaths::Combine(OutputDir, SuiteName + TEXT(".csv"));
+	const FString JsonPath = FPaths::Combine(OutputDir, SuiteName + TEXT(".json"));
+	const FString Json = ToJson();
+
+	if (!FFileHelper::SaveStringToFile(ToCsv(), *CsvPath) || !FFileHelper::SaveStringToFile(Json, *JsonPath))
+	{
+		Test.AddError(FString::Printf(TEXT("Could not write benchmark results to %s"), *OutputDir));
+	}
+	else
+	{
+		Test.AddInfo(FString::Printf(TEXT("%d results written to %s"), Results.Num(), *CsvPath));
+	}
+
+	const TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("Minesweeper"));
+	if (!Plugin.IsValid())
+	{
+		Test.AddError(TEXT("Minesweeper plugin not found, can't locate the benchmark baselines"));
+		return;
+	}
+
+	const FString BaselinePath = FPaths::Combine(Plugin->GetBaseDir(), TEXT("Benchmarks"), FString::Printf(TEXT("%sBaseline-%s.json"), *SuiteName, FPlatformProperties::IniPlatformName()));
+
+	// Baselines are part of the plugin source, they are only written when asked for and then checked in
+	if (CVarMinesweeperBenchmarkUpdateBaseline.GetValueOnGameThread())
+	{
+		if (FFileHelper::SaveStringToFile(Json, *BaselinePath))
+		{
+			Test.AddInfo(FString::Printf(TEXT("Baseline recorded: %s"), *BaselinePath));
+		}
+		else
+		{
+			Test.AddError(FString::Printf(TEXT("Could not write the baseline %s"), *BaselinePath));
+		}
+		return;
+	}
+
+	CompareWithBaseline(Test, BaselinePath);
+}
+
+FString FMinesweeperBenchmarkReport::ToCsv() const
+{
+	FString Csv = TEXT("Metric,Case,Microseconds,Samples\n");
+	for (const FMinesweeperBenchmarkResult& Result : Results)
+	{
+		Csv += FString::Printf(TEXT("%s,%s,%.3f,%d\n"), *Result.Metric, *Result.Case, Result.Microseconds, Result.Samples);
+	}
+
+	return Csv;
+}
+
+FString FMinesweeperBenchmarkReport::ToJson() const
+{
+	TArray<TSharedPtr<FJsonValue>> ResultValues;
+	for (const FMinesweeperBenchmarkResult& Result : Results)
+	{
+		const TSharedRef<FJsonObject> ResultObject = MakeShared<FJsonObject>();
+		ResultObject->SetStringField(TEXT("Metric"), Result.Metric);
+		ResultObject->SetStringField(TEXT("Case"), Result.Case);
+		ResultObject->SetNumberField(TEXT("Microseconds"), Result.Microseconds);
+		ResultObject->SetNumberField(TEXT("Samples"), Result.Samples);
+		ResultValues.Add(MakeShared<FJsonValueObject>(ResultObject));
+	}
+
+	const TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetStringField(TEXT("Suite"), SuiteName);
+	Root->SetStringField(TEXT("Platform"), FPlatformProperties::IniPlatformName());
+	Root->SetArrayField(TEXT("Results"), ResultValues);
+
+	FString Json;
+	FJsonSerializer::Serialize(Root, TJsonWriterFactory<>::Create(&Json));
+	return Json;
+}
+
+bool FMinesweeperBenchmarkReport::ParseJson(const FString& Json, FString& OutPlatform, TArray<FMinesweeperBenchmarkResult>& OutResults)
+{
+	TSharedPtr<FJsonObject> Root;
+	if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Json), Root) || !Root.IsValid())
+		return false;
+
+	const TArray<TSharedPtr<FJsonValue>>* ResultValues = nullptr;
+	if (!Root->TryGetArrayField(TEXT("Results"), ResultValues))
+		return false;
+
+	OutPlatform = Root->GetStringField(TEXT("Platform"));
+
+	for (const TSharedPtr<FJsonValue>& ResultValue : *ResultValues)
+	{
+		const TSharedPtr<FJsonObject> ResultObject = ResultValue->AsObject();
+		if (!ResultObject.IsValid())
+			continue;
+
+		FMinesweeperBenchmarkResult& Result = OutResults.AddDefaulted_GetRef();
+		Result.Metric = ResultObject->GetStringField(TEXT("Metric"));
+		Result.Case = ResultObject->GetStringField(TEXT("Case"));
+		Result.Microseconds = ResultObject->GetNumberField(TEXT("Microseconds"));
+		Result.Samples = static_cast<int32>(ResultObject->GetNumberField(TEXT("Samples")));
+	}
+
+	return true;
+}
+
+void FMinesweeperBenchmarkReport::CompareWithBaseline(FAutomationTestBase& Test, const FString& BaselinePath) const
+{
+	FString BaselineJson;
+	FString BaselinePlatform;
+	TArray<FMinesweeperBenchmarkResult> BaselineResults;
+	if (!FFileHelper::LoadFileToString(BaselineJson, *BaselinePath) || !ParseJson(BaselineJson, BaselinePlatform, BaselineResults))
+	{
+		Test.AddWarning(FString::Printf(TEXT("No usable baseline at %s, nothing was compared. Record one with Minesweeper.Benchmark.UpdateBaseline 1 and check it in."), *BaselinePath));
+		return;
+	}
+
+	// Timings of different platforms say nothing about each other
+	if (BaselinePlatform != FPlatformProperties::IniPlatformName())
+	{
+		Test.AddWarning(FString::Printf(TEXT("Baseline %s was recorded on %s, not compared on %s"), *BaselinePath, *BaselinePlatform, FPlatformProperties::IniPlatformName()));
+		return;
+	}
+
+	TMap<FString, double> BaselineMicroseconds;
+	for (const FMinesweeperBenchmarkResult& BaselineResult : BaselineResults)
+	{
+		BaselineMicroseconds.Add(BaselineResult.GetKey(), BaselineResult.Microseconds);
+	}
+
+	const double Threshold = CVarMinesweeperBenchmarkRegressionThreshold.GetValueOnGameThread();
+	int32 NumRegressions = 0;
+	for (const FMinesweeperBenchmarkResult& Result : Results)
+	{
+		const double* Baseline = BaselineMicroseconds.Find(Result.GetKey());
+		if (Baseline == nullptr)
+		{
+			Test.AddInfo(FString::Printf(TEXT("%s: %.3f us, not in the baseline"), *Result.GetKey(), Result.Microseconds));
+			continue;
+		}
+
+		const double Ratio = *Baseline > 0.0 ? Result.Microseconds / *Baseline : 1.0;
+		if (Ratio > 1.0 + Threshold && Result.Microseconds - *Baseline > MinRegressionMicroseconds)
+		{
+			Test.AddError(FString::Printf(TEXT("%s regressed: %.3f us against a baseline of %.3f us (%+.0f%%)"), *Result.GetKey(), Result.Microseconds, *Baseline, (Ratio - 1.0) * 100.0));
+			++NumRegressions;
+		}
+	}
+
+	Test.AddInfo(FString::Printf(TEXT("%d of %d results regressed by more than %.0f%% against %s"), NumRegressions, Results.Num(), Threshold * 100.0, *BaselinePath));
+}
+
+#endif
@@ -0,0 +1,63 @@
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+class FAutomationTestBase;
+
+/** Median time of one benchmarked operation on one scenario */
+struct FMinesweeperBenchmarkResult
+{
+	/** What was timed, e.g. InitializeGame */
+	FString Metric;
+
+	/** Scenario it was timed on, e.g. 512x512 15% */
+	FString Case;
+
+	double Microseconds = 0.0;
+
+	/** Runs the median was taken over */
+	int32 Samples = 0;
+
+	FString GetKey() const { return Metric + TEXT(" | ") + Case; }
+};
+
+/**
+ * Results of one benchmark suite
+ * Written to Saved/Minesweeper/Benchmarks/<Suite>.csv and .json, then compared against
+ * Plugins/Minesweeper/Benchmarks/<Suite>Baseline-<Platform>.json: a result slower than the baseline by more than
+ * Minesweeper.Benchmark.RegressionThreshold fails the test.
+ * A missing baseline is reported as a warning and nothing is compared. Baselines are only written when
+ * Minesweeper.Benchmark.UpdateBaseline is set, on the reference machine, after an intended change in performance.
+ */
+class FMinesweeperBenchmarkReport
+{
+public:
+	explicit FMinesweeperBenchmarkReport(const FString& InSuiteName);
+
+	/** Adds the median of the given run times, in seconds */
+	void Add(const FString& Metric, const FString& Case, TArray<double> SampleSeconds);
+
+	const TArray<FMinesweeperBenchmarkResult>& GetResults() const { return Results; }
+
+	/** Writes the CSV and JSON files, then compares against the baseline or updates it */
+	void Finish(FAutomationTestBase& Test) const;
+
+private:
+	FString ToCsv() const;
+	FString ToJson() const;
+	static bool ParseJson(const FString& Json, FString& OutPlatform, TArray<FMinesweeperBenchmarkResult>& OutResults);
+
+	void CompareWithBaseline(FAutomationTestBase& Test, const FString& BaselinePath) const;
+
+	/** Differences smaller than this are noise whatever the ratio, in microseconds */
+	static constexpr double MinRegressionMicroseconds = 1.0;
+
+	FString SuiteName;
+	TArray<FMinesweeperBenchmarkResult> Results;
+};
+
+#endif
@@ -0,0 +1,192 @@
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Widgets/SMinesweeperBoardWidget.h"
+#include "MinesweeperCore.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Framework/Application/SlateApplication.h"
+#include "Input/HittestGrid.h"
+#include "Misc/AutomationTest.h"
+#include "Rendering/DrawElements.h"
+#include "Widgets/SWindow.h"
+
+/**
+ * Checks that the level of detail pyramid follows change sets
+ * Change sets only mark texel rows stale, the rows are recounted from the board a few at a time. Once all are
+ * recounted, the pyramid must match one built from scratch.
+ */
+struct FMinesweeperBoardWidgetTest
+{
+	static constexpr int32 BoardSize = 512;
+	static constexpr int32 BombCount = BoardSize * BoardSize / 100;
+	static constexpr int32 Seed = 12345;
+
+	static constexpr float ViewportSize = 1024.0f;
+
+	static void Run(FAutomationTestBase& Test)
+	{
+		FMinesweeperGameSettings Settings(BoardSize, BoardSize, BombCount, Seed);
+		Settings.bLargeBoard = true;
+		Settings.CellLayout = EMinesweeperCellLayout::Blocked8x8;
+		Settings.ValidateAndClamp();
+
+		const TSharedRef<FMinesweeperCore> GameCore = MakeShared<FMinesweeperCore>();
+		GameCore->InitializeGame(Settings);
+
+		const TSharedRef<SMinesweeperBoardWidget> BoardWidget = SNew(SMinesweeperBoardWidget);
+		BoardWidget->SetGameCore(GameCore);
+
+		const TSharedRef<SWindow> Window = SNew(SWindow)
+			.ClientSize(FVector2D(ViewportSize, ViewportSize))
+			.CreateTitleBar(false)
+			[
+				BoardWidget
+			];
+
+		// One opening before the pyramid exists, it is counted when the zoomed out board is painted and builds the pyramid from the core
+		FMinesweeperChangeSet ChangeSet;
+		if (!RevealLargestOpening(*GameCore, ChangeSet))
+		{
+			Test.AddError(TEXT("The test board has no opening to reveal"));
+			return;
+		}
+
+		BoardWidget->ApplyChangeSet(ChangeSet);
+		BoardWidget->TilePitch = 1.0f;
+		PaintWindow(Window);
+
+		if (BoardWidget->LodLevels.IsEmpty())
+		{
+			Test.AddError(TEXT("Painting the zoomed out board did not build the level of detail pyramid"));
+			return;
+		}
+
+		// Another opening and a flag once the pyramid is built
+		FIntPoint FlagTile(INDEX_NONE, INDEX_NONE);
+		if (!RevealLargestOpening(*GameCore, ChangeSet) || !FindHiddenTile(*GameCore, FlagTile))
+		{
+			Test.AddError(TEXT("The test board has no second opening to reveal"));
+			return;
+		}
+
+		BoardWidget->ApplyChangeSet(ChangeSet);
+		GameCore->ToggleFlag(FlagTile.X, FlagTile.Y, &ChangeSet);
+		BoardWidget->ApplyChangeSet(ChangeSet);
+		Test.TestTrue(TEXT("Change sets leave texel rows to recount"), BoardWidget->HasStaleLevelOfDetail());
+
+		// No budget, every refresh recounts a single row
+		int32 NumRefreshes = 1;
+		while (!BoardWidget->RefreshLevelOfDetail(0.0))
+		{
+			++NumRefreshes;
+		}
+		Test.TestTrue(TEXT("Every refresh recounts at least one texel row"), NumRefreshes <= BoardWidget->LodLevels[0].Height);
+
+		const TArray<SMinesweeperBoardWidget::FLodLevel> RefreshedLevels = BoardWidget->LodLevels;
+		BoardWidget->BuildLodPyramid(*GameCore);
+
+		for (int32 Level = 0; Level < RefreshedLevels.Num(); ++Level)
+		{
+			int32 Revealed = 0;
+			int32 Flagged = 0;
+			int32 NumMismatches = 0;
+			for (int32 TexelIndex = 0; TexelIndex < RefreshedLevels[Level].Texels.Num(); ++TexelIndex)
+			{
+				const SMinesweeperBoardWidget::FLodTexel& Texel = RefreshedLevels[Level].Texels[TexelIndex];
+				const SMinesweeperBoardWidget::FLodTexel& BuiltTexel = BoardWidget->LodLevels[Level].Texels[TexelIndex];
+				Revealed += Texel.Revealed;
+				Flagged += Texel.Flagged;
+				NumMismatches += Texel.Revealed != BuiltTexel.Revealed || Texel.Flagged != BuiltTexel.Flagged ? 1 : 0;
+			}
+
+			Test.TestEqual(FString::Printf(TEXT("Revealed tiles in level %d"), Level), Revealed, GameCore->GetRevealedTileCount());
+			Test.TestEqual(FString::Printf(TEXT("Flagged tiles in level %d"), Level), Flagged, GameCore->GetFlaggedTileCount());
+			Test.TestEqual(FString::Printf(TEXT("Texels of level %d that differ from a rebuilt pyramid"), Level), NumMismatches, 0);
+		}
+	}
+
+	/** Reveals the largest zero region that is still hidden */
+	static bool RevealLargestOpening(FMinesweeperCore& GameCore, FMinesweeperChangeSet& OutChangeSet)
+	{
+		const FMinesweeperBoard& Board = GameCore.GetBoard();
+
+		TArray<int32> RegionSizes;
+		RegionSizes.SetNumZeroed(Board.GetNumZeroRegions());
+
+		TArray<FIntPoint> RegionTiles;
+		RegionTiles.SetNumUninitialized(Board.GetNumZeroRegions());
+
+		Board.ForEachTile([&](const int32 CellIndex, const int32 X, const int32 Y) {
+			const int32 Region = Board.GetZeroRegion(CellIndex);
+			if (Region != INDEX_NONE && !Board.IsRevealed(CellIndex) && RegionSizes[Region]++ == 0)
+			{
+				RegionTiles[Region] = FIntPoint(X, Y);
+			}
+		});
+
+		int32 LargestRegion = INDEX_NONE;
+		for (int32 Region = 0; Region < RegionSizes.Num(); ++Region)
+		{
+			if (RegionSizes[Region] > 0 && (LargestRegion == INDEX_NONE || RegionSizes[Region] > RegionSizes[LargestRegion]))
+			{
+				LargestRegion = Region;
+			}
+		}
+
+		if (LargestRegion == INDEX_NONE)
+			return false;
+
+		GameCore.RevealTile(RegionTiles[LargestRegion].X, RegionTiles[LargestRegion].Y, &OutChangeSet);
+		return !OutChangeSet.RevealedCells.IsEmpty();
+	}
+
+	static bool FindHiddenTile(const FMinesweeperCore& GameCore, FIntPoint& OutTile)
+	{
+		for (int32 Y = 0; Y < BoardSize; ++Y)
+		{
+			for (int32 X = 0; X < BoardSize; ++X)
+			{
+				if (!GameCore.GetTile(X, Y)->bIsRevealed)
+				{
+					OutTile = FIntPoint(X, Y);
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+	static void PaintWindow(const TSharedRef<SWindow>& Window)
+	{
+		const FVector2f WindowSize(ViewportSize, ViewportSize);
+		const FGeometry WindowGeometry = FGeometry::MakeRoot(WindowSize, FSlateLayoutTransform());
+		const FSlateRect CullingRect(FVector2f::ZeroVector, WindowSize);
+
+		Window->SlatePrepass(1.0f);
+
+		FSlateWindowElementList ElementList(Window);
+		FHittestGrid HittestGrid;
+		const FPaintArgs PaintArgs(nullptr, HittestGrid, FVector2f::ZeroVector, FPlatformTime::Seconds(), 0.0f);
+		Window->Paint(PaintArgs, WindowGeometry, CullingRect, ElementList, 0, FWidgetStyle(), true);
+	}
+};
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMinesweeperBoardWidgetLodTest, "Minesweeper.BoardWidget.LodFollowsChangeSets", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FMinesweeperBoardWidgetLodTest::RunTest(const FString& Parameters)
+{
+	if (!FSlateApplication::IsInitialized())
+	{
+		AddError(TEXT("Slate is not initialized, the board widget test needs an editor session"));
+		return false;
+	}
+
+	FMinesweeperBoardWidgetTest::Run(*this);
+
+	return !HasAnyErrors();
+}
+
+#endif
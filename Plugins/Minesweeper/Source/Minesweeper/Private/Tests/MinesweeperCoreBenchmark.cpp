@@ -0,0 +1,213 @@
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "MinesweeperCore.h"
+#include "Tests/MinesweeperBenchmarkReport.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HAL/IConsoleManager.h"
+#include "Misc/AutomationTest.h"
+
+/**
+ * Times the core step by step over a matrix of board sizes and bomb densities
+ * A friend of FMinesweeperCore, so the private generation steps and the win check can be timed on their own.
+ * Every case uses the same seed, so a case always times the same board.
+ *
+ * WorstCaseFlood reveals the largest opening through its precomputed zero region, WorstCaseWorklistFlood
+ * reveals the same opening with a flag inside it, which leaves it to the tile by tile flood.
+ *
+ * Move metrics time a whole batch of moves, single moves are too short to time one by one. The batch size is
+ * part of the metric name, it only depends on the board so it is the same from run to run.
+ */
+struct FMinesweeperCoreBenchmark
+{
+	static constexpr int32 BoardSizes[] = { 16, 128, 512, 2048 };
+	static constexpr int32 DensityPercents[] = { 5, 15, 25 };
+	static constexpr int32 Seed = 12345;
+
+	/** Runs per metric and case, the median is reported */
+	static constexpr int32 Iterations = 5;
+
+	/** Moves per batch, at most */
+	static constexpr int32 RevealsPerRun = 256;
+	static constexpr int32 FlaggedTilesPerRun = 256;
+	static constexpr int32 WinChecksPerRun = 10000;
+
+	static void Run(FMinesweeperBenchmarkReport& Report)
+	{
+		for (const int32 Size : BoardSizes)
+		{
+			for (const int32 DensityPercent : DensityPercents)
+			{
+				FMinesweeperGameSettings Settings(Size, Size, 1, Seed);
+				Settings.bLargeBoard = true;
+				Settings.BombCount = FMath::Max(1, Size * Size * DensityPercent / 100);
+				Settings.ValidateAndClamp();
+
+				RunCase(Settings, FString::Printf(TEXT("%dx%d %d%%"), Settings.GridWidth, Settings.GridHeight, DensityPercent), Report);
+			}
+		}
+	}
+
+	static void RunCase(const FMinesweeperGameSettings& Settings, const FString& Case, FMinesweeperBenchmarkReport& Report)
+	{
+		// Same switch InitializeGame reads, so the adjacency step is timed the way generation runs it
+		const IConsoleVariable* ParallelGeneration = IConsoleManager::Get().FindConsoleVariable(TEXT("Minesweeper.ParallelGeneration"));
+		const bool bParallel = ParallelGeneration != nullptr && ParallelGeneration->GetBool();
+
+		// Targets of the move metrics, picked once since every run plays the same board
+		FMinesweeperCore ReferenceCore;
+		ReferenceCore.InitializeGame(Settings);
+
+		TArray<FIntPoint> NumberTiles;
+		FIntPoint FloodTile, FloodFlagTile;
+		const bool bHasFloodTile = FindLargestOpening(ReferenceCore.GetBoard(), FloodTile, FloodFlagTile);
+		const bool bHasFloodFlagTile = bHasFloodTile && FloodFlagTile != FloodTile;
+		ReferenceCore.GetBoard().ForEachTile([&](const int32 CellIndex, const int32 X, const int32 Y) {
+			const FMinesweeperBoard& Board = ReferenceCore.GetBoard();
+			if (NumberTiles.Num() < RevealsPerRun && !Board.IsBomb(CellIndex) && Board.GetAdjacentBombs(CellIndex) > 0)
+			{
+				NumberTiles.Emplace(X, Y);
+			}
+		});
+
+		const int32 NumFlaggedTiles = FMath::Min(FlaggedTilesPerRun, Settings.GetTotalTiles());
+
+		TArray<double> PlaceBombsSeconds, AdjacentBombsSeconds, InitializeSeconds, RevealSeconds, FloodSeconds, WorklistFloodSeconds, FlagSeconds, WinCheckSeconds;
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			FMinesweeperCore Core;
+
+			// Generation steps one at a time, on the storage InitializeGame would set up
+			Core.GameSettings = Settings;
+			Core.Board.Initialize(Settings.GridWidth, Settings.GridHeight, Settings.CellLayout);
+
+			double StartTime = FPlatformTime::Seconds();
+			Core.PlaceBombsRandomly(FOnMinesweeperGenerationProgress());
+			PlaceBombsSeconds.Add(FPlatformTime::Seconds() - StartTime);
+
+			StartTime = FPlatformTime::Seconds();
+			Core.CalculateAdjacentBombs(bParallel, FOnMinesweeperGenerationProgress());
+			AdjacentBombsSeconds.Add(FPlatformTime::Seconds() - StartTime);
+
+			// Whole generation, reallocation and zero regions included
+			StartTime = FPlatformTime::Seconds();
+			Core.InitializeGame(Settings);
+			InitializeSeconds.Add(FPlatformTime::Seconds() - StartTime);
+
+			StartTime = FPlatformTime::Seconds();
+			for (const FIntPoint& Tile : NumberTiles)
+			{
+				Core.RevealTile(Tile.X, Tile.Y);
+			}
+			RevealSeconds.Add(FPlatformTime::Seconds() - StartTime);
+
+			if (bHasFloodTile)
+			{
+				Core.InitializeGame(Settings);
+				StartTime = FPlatformTime::Seconds();
+				Core.RevealTile(FloodTile.X, FloodTile.Y);
+				FloodSeconds.Add(FPlatformTime::Seconds() - StartTime);
+			}
+
+			// A flag inside the opening rules out the precomputed region, the same opening is flooded tile by tile
+			if (bHasFloodFlagTile)
+			{
+				Core.InitializeGame(Settings);
+				Core.ToggleFlag(FloodFlagTile.X, FloodFlagTile.Y);
+				StartTime = FPlatformTime::Seconds();
+				Core.RevealTile(FloodTile.X, FloodTile.Y);
+				WorklistFloodSeconds.Add(FPlatformTime::Seconds() - StartTime);
+			}
+
+			// Flag the first tiles, then clear them again in the opposite order
+			Core.InitializeGame(Settings);
+			StartTime = FPlatformTime::Seconds();
+			for (int32 TileIndex = 0; TileIndex < NumFlaggedTiles; ++TileIndex)
+			{
+				Core.ToggleFlag(TileIndex % Settings.GridWidth, TileIndex / Settings.GridWidth);
+			}
+			for (int32 TileIndex = NumFlaggedTiles - 1; TileIndex >= 0; --TileIndex)
+			{
+				Core.ToggleFlag(TileIndex % Settings.GridWidth, TileIndex / Settings.GridWidth);
+			}
+			FlagSeconds.Add(FPlatformTime::Seconds() - StartTime);
+
+			StartTime = FPlatformTime::Seconds();
+			for (int32 Check = 0; Check < WinChecksPerRun; ++Check)
+			{
+				Core.CheckWinCondition();
+			}
+			WinCheckSeconds.Add(FPlatformTime::Seconds() - StartTime);
+		}
+
+		Report.Add(TEXT("InitializeGame"), Case, InitializeSeconds);
+		Report.Add(TEXT("PlaceBombsRandomly"), Case, PlaceBombsSeconds);
+		Report.Add(TEXT("CalculateAdjacentBombs"), Case, AdjacentBombsSeconds);
+		Report.Add(FString::Printf(TEXT("SingleClickReveal x%d"), NumberTiles.Num()), Case, RevealSeconds);
+		Report.Add(TEXT("WorstCaseFlood"), Case, FloodSeconds);
+		Report.Add(TEXT("WorstCaseWorklistFlood"), Case, WorklistFloodSeconds);
+		Report.Add(FString::Printf(TEXT("ToggleFlag x%d"), NumFlaggedTiles * 2), Case, FlagSeconds);
+		Report.Add(FString::Printf(TEXT("CheckWinCondition x%d"), WinChecksPerRun), Case, WinCheckSeconds);
+	}
+
+	/**
+	 * Finds a zero tile of the largest opening, the most a single click can reveal
+	 * @param OutLastTile The last zero tile of the same opening, OutTile itself when the opening has a single zero tile
+	 */
+	static bool FindLargestOpening(const FMinesweeperBoard& Board, FIntPoint& OutTile, FIntPoint& OutLastTile)
+	{
+		TArray<int32> RegionSizes;
+		RegionSizes.SetNumZeroed(Board.GetNumZeroRegions());
+
+		TArray<FIntPoint> RegionTiles, RegionLastTiles;
+		RegionTiles.SetNumUninitialized(Board.GetNumZeroRegions());
+		RegionLastTiles.SetNumUninitialized(Board.GetNumZeroRegions());
+
+		Board.ForEachTile([&](const int32 CellIndex, const int32 X, const int32 Y) {
+			const int32 Region = Board.GetZeroRegion(CellIndex);
+			if (Region == INDEX_NONE)
+				return;
+
+			if (RegionSizes[Region]++ == 0)
+			{
+				RegionTiles[Region] = FIntPoint(X, Y);
+			}
+			RegionLastTiles[Region] = FIntPoint(X, Y);
+		});
+
+		int32 LargestRegion = INDEX_NONE;
+		for (int32 Region = 0; Region < RegionSizes.Num(); ++Region)
+		{
+			if (LargestRegion == INDEX_NONE || RegionSizes[Region] > RegionSizes[LargestRegion])
+			{
+				LargestRegion = Region;
+			}
+		}
+
+		if (LargestRegion == INDEX_NONE)
+			return false;
+
+		OutTile = RegionTiles[LargestRegion];
+		OutLastTile = RegionLastTiles[LargestRegion];
+		return true;
+	}
+};
+
+/**
+ * Core benchmark suite, runs without a GPU:
+ * UnrealEditor-Cmd MineSweeperHolder.uproject -NullRHI -unattended -ExecCmds="Automation RunTests Minesweeper.Benchmark.Core; Quit"
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMinesweeperCoreBenchmarkTest, "Minesweeper.Benchmark.Core", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FMinesweeperCoreBenchmarkTest::RunTest(const FString& Parameters)
+{
+	FMinesweeperBenchmarkReport Report(TEXT("Core"));
+	FMinesweeperCoreBenchmark::Run(Report);
+	Report.Finish(*this);
+
+	return !HasAnyErrors();
+}
+
+#endif
@@ -0,0 +1,501 @@
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "MinesweeperCore.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+
+/**
+ * Functional checks of the core and its board storage, they run without a GPU:
+ * UnrealEditor-Cmd MineSweeperHolder.uproject -NullRHI -unattended -ExecCmds="Automation RunTests Minesweeper.Core; Quit"
+ */
+namespace MinesweeperCoreTest
+{
+	constexpr EMinesweeperCellLayout Layouts[] = { EMinesweeperCellLayout::RowMajor, EMinesweeperCellLayout::Blocked8x8 };
+
+	const TCHAR* GetLayoutName(const EMinesweeperCellLayout Layout)
+	{
+		return Layout == EMinesweeperCellLayout::RowMajor ? TEXT("RowMajor") : TEXT("Blocked8x8");
+	}
+
+	/** Adjacent bombs of a tile from a plain look at its 3x3 neighbourhood, the reference for the word-wide kernels */
+	int32 CountAdjacentBombs(const FMinesweeperBoard& Board, const int32 X, const int32 Y)
+	{
+		int32 Count = 0;
+		for (int32 NeighborY = FMath::Max(Y - 1, 0); NeighborY <= FMath::Min(Y + 1, Board.GetHeight() - 1); ++NeighborY)
+		{
+			for (int32 NeighborX = FMath::Max(X - 1, 0); NeighborX <= FMath::Min(X + 1, Board.GetWidth() - 1); ++NeighborX)
+			{
+				if ((NeighborX != X || NeighborY != Y) && Board.IsBomb(Board.GetCellIndex(NeighborX, NeighborY)))
+				{
+					++Count;
+				}
+			}
+		}
+		return Count;
+	}
+
+	/** Number of tiles whose state or count differs between two games of the same size */
+	int32 CountTileMismatches(const FMinesweeperCore& GameCore, const FMinesweeperCore& OtherGameCore)
+	{
+		const FMinesweeperGameSettings& Settings = GameCore.GetGameSettings();
+
+		int32 NumMismatches = 0;
+		for (int32 Y = 0; Y < Settings.GridHeight; ++Y)
+		{
+			for (int32 X = 0; X < Settings.GridWidth; ++X)
+			{
+				const FMinesweeperTileProxy Tile = GameCore.GetTile(X, Y);
+				const FMinesweeperTileProxy OtherTile = OtherGameCore.GetTile(X, Y);
+				NumMismatches += Tile->bIsBomb != OtherTile->bIsBomb
+					|| Tile->bIsRevealed != OtherTile->bIsRevealed
+					|| Tile->bIsFlagged != OtherTile->bIsFlagged
+					|| Tile->AdjacentBombs != OtherTile->AdjacentBombs ? 1 : 0;
+			}
+		}
+		return NumMismatches;
+	}
+
+	/** First tile without adjacent bombs, reading order */
+	bool FindZeroTile(const FMinesweeperCore& GameCore, FIntPoint& OutTile)
+	{
+		const FMinesweeperGameSettings& Settings = GameCore.GetGameSettings();
+		for (int32 Y = 0; Y < Settings.GridHeight; ++Y)
+		{
+			for (int32 X = 0; X < Settings.GridWidth; ++X)
+			{
+				const FMinesweeperTileProxy Tile = GameCore.GetTile(X, Y);
+				if (!Tile->bIsBomb && Tile->AdjacentBombs == 0)
+				{
+					OutTile = FIntPoint(X, Y);
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	/** First tile matching Predicate(X, Y), reading order */
+	template <typename PredicateType>
+	bool FindTile(const FMinesweeperCore& GameCore, PredicateType&& Predicate, FIntPoint& OutTile)
+	{
+		const FMinesweeperGameSettings& Settings = GameCore.GetGameSettings();
+		for (int32 Y = 0; Y < Settings.GridHeight; ++Y)
+		{
+			for (int32 X = 0; X < Settings.GridWidth; ++X)
+			{
+				if (Predicate(X, Y))
+				{
+					OutTile = FIntPoint(X, Y);
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	/** Calls Func(X, Y) for each on-board neighbour of (X, Y) */
+	template <typename FuncType>
+	void ForEachNeighborTile(const FMinesweeperCore& GameCore, const int32 X, const int32 Y, FuncType&& Func)
+	{
+		for (int32 NeighborY = Y - 1; NeighborY <= Y + 1; ++NeighborY)
+		{
+			for (int32 NeighborX = X - 1; NeighborX <= X + 1; ++NeighborX)
+			{
+				if ((NeighborX != X || NeighborY != Y) && GameCore.IsValidCoordinate(NeighborX, NeighborY))
+				{
+					Func(NeighborX, NeighborY);
+				}
+			}
+		}
+	}
+
+	/**
+	 * Reveal state of every tile after revealing (X, Y), from a plain breadth-first walk over the tile queries
+	 * The reference for both the zero region and the flood path: zero tiles open their hidden, unflagged neighbours.
+	 */
+	TArray<bool> GetExpectedRevealedTiles(const FMinesweeperCore& GameCore, const int32 X, const int32 Y)
+	{
+		const int32 Width = GameCore.GetGameSettings().GridWidth;
+		const int32 Height = GameCore.GetGameSettings().GridHeight;
+
+		TArray<bool> Revealed;
+		Revealed.SetNumUninitialized(Width * Height);
+		for (int32 TileIndex = 0; TileIndex < Width * Height; ++TileIndex)
+		{
+			Revealed[TileIndex] = GameCore.GetTile(TileIndex % Width, TileIndex / Width)->bIsRevealed;
+		}
+
+		TArray<FIntPoint> Worklist = { FIntPoint(X, Y) };
+		Revealed[Y * Width + X] = true;
+		while (!Worklist.IsEmpty())
+		{
+			const FIntPoint Tile = Worklist.Pop();
+			if (GameCore.GetTile(Tile.X, Tile.Y)->AdjacentBombs != 0)
+				continue;
+
+			for (int32 NeighborY = FMath::Max(Tile.Y - 1, 0); NeighborY <= FMath::Min(Tile.Y + 1, Height - 1); ++NeighborY)
+			{
+				for (int32 NeighborX = FMath::Max(Tile.X - 1, 0); NeighborX <= FMath::Min(Tile.X + 1, Width - 1); ++NeighborX)
+				{
+					const int32 NeighborIndex = NeighborY * Width + NeighborX;
+					if (!Revealed[NeighborIndex] && !GameCore.GetTile(NeighborX, NeighborY)->bIsFlagged)
+					{
+						Revealed[NeighborIndex] = true;
+						Worklist.Emplace(NeighborX, NeighborY);
+					}
+				}
+			}
+		}
+
+		return Revealed;
+	}
+}
+
+/** Reaches into the core to pick the path a reveal takes */
+struct FMinesweeperCoreTest
+{
+	/** True when revealing the zero tile at (X, Y) would open its precomputed region in bulk */
+	static bool WouldRevealInBulk(const FMinesweeperCore& GameCore, const int32 X, const int32 Y)
+	{
+		const int32 Region = GameCore.Board.GetZeroRegion(GameCore.Board.GetCellIndex(X, Y));
+		return Region != INDEX_NONE && GameCore.ZeroRegionFlagCounts[Region] == 0 && !GameCore.OpenedZeroRegions[Region];
+	}
+
+	/** Reveals the tile at (X, Y) through the tile by tile flood, even where its region could be opened in bulk */
+	static void RevealWithFlood(FMinesweeperCore& GameCore, const int32 X, const int32 Y)
+	{
+		const int32 Region = GameCore.Board.GetZeroRegion(GameCore.Board.GetCellIndex(X, Y));
+		if (Region != INDEX_NONE)
+		{
+			GameCore.OpenedZeroRegions[Region] = true;
+		}
+
+		GameCore.RevealTile(X, Y);
+	}
+};
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMinesweeperAdjacentCountsTest, "Minesweeper.Core.AdjacentCounts", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FMinesweeperAdjacentCountsTest::RunTest(const FString& Parameters)
+{
+	using namespace MinesweeperCoreTest;
+
+	// Single rows and columns, odd widths, and widths around the 64 cells of a plane word (the border ring adds 2)
+	const FIntPoint Sizes[] = { { 1, 1 }, { 1, 37 }, { 37, 1 }, { 7, 9 }, { 13, 5 }, { 62, 17 }, { 63, 17 }, { 64, 17 }, { 65, 17 }, { 127, 9 }, { 129, 33 } };
+	const int32 DensityPercents[] = { 10, 50, 90 };
+
+	for (const EMinesweeperCellLayout Layout : Layouts)
+	{
+		for (const FIntPoint& Size : Sizes)
+		{
+			for (const int32 DensityPercent : DensityPercents)
+			{
+				for (const bool bParallel : { false, true })
+				{
+					FMinesweeperBoard Board;
+					Board.Initialize(Size.X, Size.Y, Layout);
+
+					FRandomStream RandomStream(Size.X * 1000 + Size.Y * 10 + DensityPercent);
+					for (int32 Y = 0; Y < Size.Y; ++Y)
+					{
+						for (int32 X = 0; X < Size.X; ++X)
+						{
+							Board.SetBomb(Board.GetCellIndex(X, Y), RandomStream.RandRange(0, 99) < DensityPercent);
+						}
+					}
+
+					Board.ComputeAdjacentCounts(bParallel);
+
+					int32 NumMismatches = 0;
+					for (int32 Y = 0; Y < Size.Y; ++Y)
+					{
+						for (int32 X = 0; X < Size.X; ++X)
+						{
+							const int32 CellIndex = Board.GetCellIndex(X, Y);
+							NumMismatches += !Board.IsBomb(CellIndex) && Board.GetAdjacentBombs(CellIndex) != CountAdjacentBombs(Board, X, Y) ? 1 : 0;
+						}
+					}
+
+					TestEqual(FString::Printf(TEXT("Wrong counts on %s %dx%d, %d%% bombs%s"), GetLayoutName(Layout), Size.X, Size.Y, DensityPercent, bParallel ? TEXT(", parallel") : TEXT("")), NumMismatches, 0);
+				}
+			}
+		}
+	}
+
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMinesweeperCellLayoutsTest, "Minesweeper.Core.CellLayouts", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FMinesweeperCellLayoutsTest::RunTest(const FString& Parameters)
+{
+	using namespace MinesweeperCoreTest;
+
+	// The layout only changes how cells are stored, a seed must give the same game in both
+	const FIntPoint Sizes[] = { { 5, 5 }, { 9, 30 }, { 63, 65 }, { 200, 150 } };
+	for (const FIntPoint& Size : Sizes)
+	{
+		FMinesweeperGameSettings Settings(Size.X, Size.Y, Size.X * Size.Y / 8, 4242);
+		Settings.bLargeBoard = true;
+
+		Settings.CellLayout = EMinesweeperCellLayout::RowMajor;
+		FMinesweeperCore RowMajorCore;
+		RowMajorCore.InitializeGame(Settings);
+
+		Settings.CellLayout = EMinesweeperCellLayout::Blocked8x8;
+		FMinesweeperCore BlockedCore;
+		BlockedCore.InitializeGame(Settings);
+
+		const FString Case = FString::Printf(TEXT("%dx%d"), Size.X, Size.Y);
+		TestEqual(FString::Printf(TEXT("Board hash of both layouts, %s"), *Case), RowMajorCore.GetBoardHash(), BlockedCore.GetBoardHash());
+
+		// Same opening in both, it must reveal the same tiles
+		FIntPoint ZeroTile;
+		if (FindZeroTile(RowMajorCore, ZeroTile))
+		{
+			RowMajorCore.RevealTile(ZeroTile.X, ZeroTile.Y);
+			BlockedCore.RevealTile(ZeroTile.X, ZeroTile.Y);
+		}
+
+		TestEqual(FString::Printf(TEXT("Tiles that differ between the layouts, %s"), *Case), CountTileMismatches(RowMajorCore, BlockedCore), 0);
+	}
+
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMinesweeperZeroRegionsTest, "Minesweeper.Core.ZeroRegions", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FMinesweeperZeroRegionsTest::RunTest(const FString& Parameters)
+{
+	using namespace MinesweeperCoreTest;
+
+	for (const EMinesweeperCellLayout Layout : Layouts)
+	{
+		FMinesweeperGameSettings Settings(96, 80, 600, 777);
+		Settings.bLargeBoard = true;
+		Settings.CellLayout = Layout;
+
+		// One game opens regions in bulk wherever it can, the other always floods
+		FMinesweeperCore BulkCore;
+		BulkCore.InitializeGame(Settings);
+		FMinesweeperCore FloodCore;
+		FloodCore.InitializeGame(Settings);
+
+		// Flags on some numbered tiles of the right half, the regions around them can't be opened in bulk any more
+		for (int32 Y = 0; Y < Settings.GridHeight; ++Y)
+		{
+			for (int32 X = Settings.GridWidth / 2; X < Settings.GridWidth; X += 5)
+			{
+				const FMinesweeperTileProxy Tile = BulkCore.GetTile(X, Y);
+				if (!Tile->bIsBomb && Tile->AdjacentBombs > 0)
+				{
+					BulkCore.ToggleFlag(X, Y);
+					FloodCore.ToggleFlag(X, Y);
+				}
+			}
+		}
+
+		// Every opening in reading order, later ones share number tiles with those already open
+		int32 NumBulkReveals = 0;
+		int32 NumFlaggedReveals = 0;
+		int32 NumWrongReveals = 0;
+		int32 NumDifferentReveals = 0;
+		for (int32 Y = 0; Y < Settings.GridHeight && BulkCore.IsGameActive(); ++Y)
+		{
+			for (int32 X = 0; X < Settings.GridWidth && BulkCore.IsGameActive(); ++X)
+			{
+				const FMinesweeperTileProxy Tile = BulkCore.GetTile(X, Y);
+				if (Tile->bIsBomb || Tile->bIsRevealed || Tile->bIsFlagged || Tile->AdjacentBombs != 0)
+					continue;
+
+				const TArray<bool> ExpectedRevealed = GetExpectedRevealedTiles(BulkCore, X, Y);
+				const bool bBulk = FMinesweeperCoreTest::WouldRevealInBulk(BulkCore, X, Y);
+				NumBulkReveals += bBulk ? 1 : 0;
+				NumFlaggedReveals += bBulk ? 0 : 1;
+
+				BulkCore.RevealTile(X, Y);
+				FMinesweeperCoreTest::RevealWithFlood(FloodCore, X, Y);
+
+				for (int32 TileIndex = 0; TileIndex < ExpectedRevealed.Num(); ++TileIndex)
+				{
+					if (BulkCore.GetTile(TileIndex % Settings.GridWidth, TileIndex / Settings.GridWidth)->bIsRevealed != ExpectedRevealed[TileIndex])
+					{
+						++NumWrongReveals;
+						break;
+					}
+				}
+				NumDifferentReveals += CountTileMismatches(BulkCore, FloodCore) != 0 ? 1 : 0;
+			}
+		}
+
+		const TCHAR* LayoutName = GetLayoutName(Layout);
+		TestTrue(FString::Printf(TEXT("Some openings were revealed in bulk, %s"), LayoutName), NumBulkReveals > 0);
+		TestTrue(FString::Printf(TEXT("Some openings held flags, %s"), LayoutName), NumFlaggedReveals > 0);
+		TestEqual(FString::Printf(TEXT("Reveals that opened other tiles than a plain flood, %s"), LayoutName), NumWrongReveals, 0);
+		TestEqual(FString::Printf(TEXT("Reveals after which the bulk and flood games differ, %s"), LayoutName), NumDifferentReveals, 0);
+		TestEqual(FString::Printf(TEXT("Revealed tiles of the bulk and flood games, %s"), LayoutName), BulkCore.GetRevealedTileCount(), FloodCore.GetRevealedTileCount());
+	}
+
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMinesweeperParallelGenerationTest, "Minesweeper.Core.ParallelGeneration", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FMinesweeperParallelGenerationTest::RunTest(const FString& Parameters)
+{
+	using namespace MinesweeperCoreTest;
+
+	IConsoleVariable* ParallelGeneration = IConsoleManager::Get().FindConsoleVariable(TEXT("Minesweeper.ParallelGeneration"));
+	if (ParallelGeneration == nullptr)
+	{
+		AddError(TEXT("Minesweeper.ParallelGeneration is not registered"));
+		return false;
+	}
+
+	const bool bWasParallel = ParallelGeneration->GetBool();
+
+	// Big enough to be split into several row bands, one with a height that does not divide evenly
+	const FIntPoint Sizes[] = { { 700, 500 }, { 1000, 333 } };
+	for (const EMinesweeperCellLayout Layout : Layouts)
+	{
+		for (const FIntPoint& Size : Sizes)
+		{
+			FMinesweeperGameSettings Settings(Size.X, Size.Y, Size.X * Size.Y / 10, 2024);
+			Settings.bLargeBoard = true;
+			Settings.CellLayout = Layout;
+
+			ParallelGeneration->Set(false, ECVF_SetByCode);
+			FMinesweeperCore SerialCore;
+			SerialCore.InitializeGame(Settings);
+
+			ParallelGeneration->Set(true, ECVF_SetByCode);
+			FMinesweeperCore ParallelCore;
+			ParallelCore.InitializeGame(Settings);
+
+			const FString Case = FString::Printf(TEXT("%s %dx%d"), GetLayoutName(Layout), Size.X, Size.Y);
+			TestEqual(FString::Printf(TEXT("Board hash of serial and parallel generation, %s"), *Case), SerialCore.GetBoardHash(), ParallelCore.GetBoardHash());
+			TestEqual(FString::Printf(TEXT("Tiles that differ between serial and parallel generation, %s"), *Case), CountTileMismatches(SerialCore, ParallelCore), 0);
+
+			// Region labels feed the bulk reveals, they must not depend on how the union-find was split either
+			const FMinesweeperBoard& SerialBoard = SerialCore.GetBoard();
+			const FMinesweeperBoard& ParallelBoard = ParallelCore.GetBoard();
+			int32 NumLabelMismatches = 0;
+			SerialBoard.ForEachTile([&](const int32 CellIndex, const int32 X, const int32 Y) {
+				NumLabelMismatches += SerialBoard.GetZeroRegion(CellIndex) != ParallelBoard.GetZeroRegion(CellIndex) ? 1 : 0;
+			});
+			TestEqual(FString::Printf(TEXT("Zero regions of serial and parallel generation, %s"), *Case), ParallelBoard.GetNumZeroRegions(), SerialBoard.GetNumZeroRegions());
+			TestEqual(FString::Printf(TEXT("Zero region labels that differ between serial and parallel generation, %s"), *Case), NumLabelMismatches, 0);
+		}
+	}
+
+	ParallelGeneration->Set(bWasParallel, ECVF_SetByCode);
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMinesweeperApplyMovesTest, "Minesweeper.Core.ApplyMoves", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FMinesweeperApplyMovesTest::RunTest(const FString& Parameters)
+{
+	using namespace MinesweeperCoreTest;
+
+	for (const EMinesweeperCellLayout Layout : Layouts)
+	{
+		FMinesweeperGameSettings Settings(16, 16, 40, 1312);
+		Settings.CellLayout = Layout;
+
+		FMinesweeperCore GameCore;
+		GameCore.InitializeGame(Settings);
+
+		const auto IsNumberTile = [&GameCore](const int32 X, const int32 Y) {
+			const FMinesweeperTileProxy Tile = GameCore.GetTile(X, Y);
+			return !Tile->bIsBomb && Tile->AdjacentBombs > 0;
+		};
+
+		// A number with at least one safe neighbour, so chording it has something to open
+		FIntPoint Number;
+		const bool bFoundNumber = FindTile(GameCore, [&](const int32 X, const int32 Y) {
+			int32 NumSafeNeighbors = 0;
+			ForEachNeighborTile(GameCore, X, Y, [&](const int32 NeighborX, const int32 NeighborY) {
+				NumSafeNeighbors += GameCore.GetTile(NeighborX, NeighborY)->bIsBomb ? 0 : 1;
+			});
+			return IsNumberTile(X, Y) && NumSafeNeighbors > 0;
+		}, Number);
+
+		FIntPoint Bomb;
+		const bool bFoundBomb = FindTile(GameCore, [&GameCore](const int32 X, const int32 Y) { return GameCore.GetTile(X, Y)->bIsBomb; }, Bomb);
+
+		if (!TestTrue(FString::Printf(TEXT("Board has a number and a bomb to play, %s"), GetLayoutName(Layout)), bFoundNumber && bFoundBomb))
+			continue;
+
+		// Only the reveal, the flags on the number's bombs and the satisfied chord change the board
+		TArray<FMinesweeperMove> Moves = {
+			FMinesweeperMove(EMinesweeperMoveType::Reveal, -1, 0),
+			FMinesweeperMove(EMinesweeperMoveType::Flag, Settings.GridWidth, Settings.GridHeight - 1),
+			FMinesweeperMove(EMinesweeperMoveType::Reveal, Number.X, Number.Y),
+			FMinesweeperMove(EMinesweeperMoveType::Reveal, Number.X, Number.Y),
+			FMinesweeperMove(EMinesweeperMoveType::Flag, Number.X, Number.Y),
+			FMinesweeperMove(EMinesweeperMoveType::Unflag, Bomb.X, Bomb.Y),
+			FMinesweeperMove(EMinesweeperMoveType::Chord, Number.X, Number.Y)
+		};
+
+		int32 NumAdjacentBombs = 0;
+		ForEachNeighborTile(GameCore, Number.X, Number.Y, [&](const int32 NeighborX, const int32 NeighborY) {
+			if (GameCore.GetTile(NeighborX, NeighborY)->bIsBomb)
+			{
+				Moves.Emplace(EMinesweeperMoveType::Flag, NeighborX, NeighborY);
+				Moves.Emplace(EMinesweeperMoveType::Flag, NeighborX, NeighborY);
+				++NumAdjacentBombs;
+			}
+		});
+		Moves.Emplace(EMinesweeperMoveType::Chord, Number.X, Number.Y);
+		Moves.Emplace(EMinesweeperMoveType::Chord, Number.X, Number.Y);
+
+		FMinesweeperChangeSet ChangeSet;
+		const int32 AppliedMoves = GameCore.ApplyMoves(Moves, &ChangeSet);
+		TestEqual(FString::Printf(TEXT("Moves applied from the valid batch, %s"), GetLayoutName(Layout)), AppliedMoves, NumAdjacentBombs + 2);
+		TestEqual(FString::Printf(TEXT("Flags placed by the valid batch, %s"), GetLayoutName(Layout)), GameCore.GetFlaggedTileCount(), NumAdjacentBombs);
+		TestTrue(FString::Printf(TEXT("Game still running after a correct chord, %s"), GetLayoutName(Layout)), GameCore.IsGameActive());
+		TestTrue(FString::Printf(TEXT("Valid batch reported changes, %s"), GetLayoutName(Layout)), !ChangeSet.IsEmpty());
+
+		int32 NumHiddenNeighbors = 0;
+		ForEachNeighborTile(GameCore, Number.X, Number.Y, [&](const int32 NeighborX, const int32 NeighborY) {
+			const FMinesweeperTileProxy Tile = GameCore.GetTile(NeighborX, NeighborY);
+			const bool bSettled = Tile->bIsBomb ? Tile->bIsFlagged && !Tile->bIsRevealed : Tile->bIsRevealed;
+			NumHiddenNeighbors += bSettled ? 0 : 1;
+		});
+		TestEqual(FString::Printf(TEXT("Neighbours of the chorded number left hidden or wrongly flagged, %s"), GetLayoutName(Layout)), NumHiddenNeighbors, 0);
+
+		// A hidden number away from everything opened so far, it must still be hidden when the batch stops at the bomb
+		FIntPoint LaterNumber;
+		const bool bFoundLaterNumber = FindTile(GameCore, [&](const int32 X, const int32 Y) {
+			return IsNumberTile(X, Y) && !GameCore.GetTile(X, Y)->bIsRevealed;
+		}, LaterNumber);
+
+		if (!TestTrue(FString::Printf(TEXT("Board has a hidden number left, %s"), GetLayoutName(Layout)), bFoundLaterNumber))
+			continue;
+
+		// Unflag first in case the bomb was one of the number's, revealing a flag is skipped rather than losing
+		const TArray<FMinesweeperMove> LosingMoves = {
+			FMinesweeperMove(EMinesweeperMoveType::Unflag, Bomb.X, Bomb.Y),
+			FMinesweeperMove(EMinesweeperMoveType::Reveal, Bomb.X, Bomb.Y),
+			FMinesweeperMove(EMinesweeperMoveType::Reveal, LaterNumber.X, LaterNumber.Y),
+			FMinesweeperMove(EMinesweeperMoveType::Flag, LaterNumber.X, LaterNumber.Y)
+		};
+
+		const bool bBombWasFlagged = GameCore.GetTile(Bomb.X, Bomb.Y)->bIsFlagged;
+		const int32 LosingAppliedMoves = GameCore.ApplyMoves(LosingMoves, &ChangeSet);
+		TestEqual(FString::Printf(TEXT("Moves applied up to the losing reveal, %s"), GetLayoutName(Layout)), LosingAppliedMoves, bBombWasFlagged ? 2 : 1);
+		TestTrue(FString::Printf(TEXT("Revealing a bomb lost the game, %s"), GetLayoutName(Layout)), GameCore.GetGameState() == EMinesweeperGameState::Lost && ChangeSet.NewGameState == EMinesweeperGameState::Lost);
+		TestTrue(FString::Printf(TEXT("Moves after the losing reveal were not applied, %s"), GetLayoutName(Layout)), !GameCore.GetTile(LaterNumber.X, LaterNumber.Y)->bIsRevealed && !GameCore.GetTile(LaterNumber.X, LaterNumber.Y)->bIsFlagged);
+		TestEqual(FString::Printf(TEXT("Moves applied once the game is over, %s"), GetLayoutName(Layout)), GameCore.ApplyMoves(Moves), 0);
+	}
+
+	return !HasAnyErrors();
+}
+
+#endif
@@ -0,0 +1,214 @@
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Widgets/SMinesweeperWidget.h"
+#include "Tests/MinesweeperBenchmarkReport.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Framework/Application/SlateApplication.h"
+#include "HAL/IConsoleManager.h"
+#include "Input/HittestGrid.h"
+#include "Misc/AutomationTest.h"
+#include "Rendering/DrawElements.h"
+#include "Widgets/SWindow.h"
+
+/**
+ * Times the Minesweeper UI offscreen, without a renderer
+ * The widget is hosted in a window that is never shown, and frames are run by hand: a prepass, then a paint
+ * into an element list that is dropped afterwards. Nothing needs a GPU, so this runs under -NullRHI.
+ *
+ * Slate ticks widgets and runs their active timers from inside the paint pass, so per-frame tick cost
+ * (the time sliced view updates included) is part of the Paint metrics.
+ */
+struct FMinesweeperSlateBenchmark
+{
+	static constexpr int32 BoardSizes[] = { 10, 50, 100, 1024, 4096 };
+	static constexpr int32 BombPercent = 15;
+	static constexpr int32 Seed = 12345;
+
+	/** Largest board the legacy view builds tile buttons for, see MineSweeperMaxTileWidgets */
+	static constexpr int32 MaxTileButtonBoardSize = 100;
+
+	/** Widgets built per case, every frame metric is the median over all frames of all of them */
+	static constexpr int32 Iterations = 3;
+	static constexpr int32 FramesPerRun = 30;
+
+	static constexpr float ViewportSize = 1280.0f;
+	static constexpr float FrameDeltaTime = 1.0f / 60.0f;
+
+	/** Longest wait for the widget to start its first, background generated game */
+	static constexpr double FirstGameTimeoutSeconds = 10.0;
+
+	static void Run(FMinesweeperBenchmarkReport& Report, FAutomationTestBase& Test)
+	{
+		IConsoleVariable* BoardView = IConsoleManager::Get().FindConsoleVariable(TEXT("Minesweeper.BoardView"));
+		const int32 OriginalBoardView = BoardView->GetInt();
+
+		TimeConstruction(Report);
+
+		for (const int32 Size : BoardSizes)
+		{
+			BoardView->Set(0, ECVF_SetByCode);
+			RunCase(Size, TEXT("painted"), Report, Test);
+
+			if (Size <= MaxTileButtonBoardSize)
+			{
+				BoardView->Set(1, ECVF_SetByCode);
+				RunCase(Size, TEXT("buttons"), Report, Test);
+			}
+		}
+
+		BoardView->Set(OriginalBoardView, ECVF_SetByCode);
+	}
+
+	static void TimeConstruction(FMinesweeperBenchmarkReport& Report)
+	{
+		TArray<double> ConstructSeconds;
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			const TSharedRef<SMinesweeperWidget> Widget = SNew(SMinesweeperWidget);
+			ConstructSeconds.Add(FPlatformTime::Seconds() - StartTime);
+		}
+
+		Report.Add(TEXT("Construct"), TEXT("default"), ConstructSeconds);
+	}
+
+	static void RunCase(const int32 Size, const TCHAR* ViewName, FMinesweeperBenchmarkReport& Report, FAutomationTestBase& Test)
+	{
+		// Same settings the widget would pick for a board of this size
+		FMinesweeperGameSettings Settings(Size, Size, 1, Seed);
+		Settings.bLargeBoard = Size > MineSweeperGameGridMax;
+		Settings.CellLayout = Settings.bLargeBoard ? EMinesweeperCellLayout::Blocked8x8 : EMinesweeperCellLayout::RowMajor;
+		Settings.ValidateAndClamp();
+		Settings.BombCount = FMath::Max(1, static_cast<int32>(int64(Settings.GridWidth) * Settings.GridHeight * BombPercent / 100));
+		Settings.ValidateAndClamp();
+
+		const FString Case = FString::Printf(TEXT("%dx%d %s"), Settings.GridWidth, Settings.GridHeight, ViewName);
+
+		TArray<double> NewSizeSeconds, SameSizeSeconds, IdlePrepassSeconds, IdlePaintSeconds, MoveSeconds, ActivePrepassSeconds, ActivePaintSeconds;
+		for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+		{
+			const TSharedRef<SMinesweeperWidget> Widget = SNew(SMinesweeperWidget);
+			const TSharedRef<SWindow> Window = SNew(SWindow)
+				.ClientSize(FVector2D(ViewportSize, ViewportSize))
+				.CreateTitleBar(false)
+				[
+					Widget
+				];
+
+			// Otherwise the default game the widget starts with could replace the benchmarked one mid-run
+			if (!WaitForFirstGame(Window, *Widget))
+			{
+				Test.AddError(FString::Printf(TEXT("%s: the widget did not start its first game within %.0f s"), *Case, FirstGameTimeoutSeconds));
+				return;
+			}
+
+			// Boards are generated up front, only the view work is timed. The first one is laid out for a new size, the second reuses that layout.
+			TSharedRef<FMinesweeperCore> GameCore = MakeShared<FMinesweeperCore>();
+			GameCore->InitializeGame(Settings);
+			double StartTime = FPlatformTime::Seconds();
+			Widget->StartGame(GameCore);
+			NewSizeSeconds.Add(FPlatformTime::Seconds() - StartTime);
+
+			GameCore = MakeShared<FMinesweeperCore>();
+			GameCore->InitializeGame(Settings);
+			StartTime = FPlatformTime::Seconds();
+			Widget->StartGame(GameCore);
+			SameSizeSeconds.Add(FPlatformTime::Seconds() - StartTime);
+
+			// First frame lays out the new board, it is not an idle frame
+			double PrepassSeconds, PaintSeconds;
+			RunFrame(Window, PrepassSeconds, PaintSeconds);
+
+			for (int32 Frame = 0; Frame < FramesPerRun; ++Frame)
+			{
+				RunFrame(Window, PrepassSeconds, PaintSeconds);
+				IdlePrepassSeconds.Add(PrepassSeconds);
+				IdlePaintSeconds.Add(PaintSeconds);
+			}
+
+			// One flag per frame through the input path, a tile and the info panel change every frame
+			for (int32 Frame = 0; Frame < FramesPerRun; ++Frame)
+			{
+				StartTime = FPlatformTime::Seconds();
+				Widget->OnTileFlagged(Frame % Settings.GridWidth, Frame / Settings.GridWidth);
+				MoveSeconds.Add(FPlatformTime::Seconds() - StartTime);
+
+				RunFrame(Window, PrepassSeconds, PaintSeconds);
+				ActivePrepassSeconds.Add(PrepassSeconds);
+				ActivePaintSeconds.Add(PaintSeconds);
+			}
+		}
+
+		// StartGame is timed as a whole, besides RefreshGameBoardUI it only rebinds the change set and updates the info panel
+		Report.Add(TEXT("RefreshGameBoardUI new size"), Case, NewSizeSeconds);
+		Report.Add(TEXT("RefreshGameBoardUI same size"), Case, SameSizeSeconds);
+		Report.Add(TEXT("Idle Prepass"), Case, IdlePrepassSeconds);
+		Report.Add(TEXT("Idle Paint"), Case, IdlePaintSeconds);
+		Report.Add(TEXT("Active Move"), Case, MoveSeconds);
+		Report.Add(TEXT("Active Prepass"), Case, ActivePrepassSeconds);
+		Report.Add(TEXT("Active Paint"), Case, ActivePaintSeconds);
+	}
+
+	/** Runs frames until the background generated default game has been started */
+	static bool WaitForFirstGame(const TSharedRef<SWindow>& Window, const SMinesweeperWidget& Widget)
+	{
+		const double EndTime = FPlatformTime::Seconds() + FirstGameTimeoutSeconds;
+		while (Widget.GenerationTimerHandle.IsValid())
+		{
+			if (FPlatformTime::Seconds() > EndTime)
+				return false;
+
+			double PrepassSeconds, PaintSeconds;
+			RunFrame(Window, PrepassSeconds, PaintSeconds);
+			FPlatformProcess::Sleep(0.001f);
+		}
+
+		return true;
+	}
+
+	/** One frame of the window, what FSlateApplication does for a visible window minus handing the elements to the renderer */
+	static void RunFrame(const TSharedRef<SWindow>& Window, double& OutPrepassSeconds, double& OutPaintSeconds)
+	{
+		const FVector2f WindowSize(ViewportSize, ViewportSize);
+		const FGeometry WindowGeometry = FGeometry::MakeRoot(WindowSize, FSlateLayoutTransform());
+		const FSlateRect CullingRect(FVector2f::ZeroVector, WindowSize);
+
+		double StartTime = FPlatformTime::Seconds();
+		Window->SlatePrepass(1.0f);
+		OutPrepassSeconds = FPlatformTime::Seconds() - StartTime;
+
+		FSlateWindowElementList ElementList(Window);
+		FHittestGrid HittestGrid;
+		const FPaintArgs PaintArgs(nullptr, HittestGrid, FVector2f::ZeroVector, FPlatformTime::Seconds(), FrameDeltaTime);
+
+		StartTime = FPlatformTime::Seconds();
+		Window->Paint(PaintArgs, WindowGeometry, CullingRect, ElementList, 0, FWidgetStyle(), true);
+		OutPaintSeconds = FPlatformTime::Seconds() - StartTime;
+	}
+};
+
+/**
+ * Slate benchmark suite, needs the editor but no GPU:
+ * UnrealEditor-Cmd MineSweeperHolder.uproject -NullRHI -unattended -ExecCmds="Automation RunTests Minesweeper.Benchmark.Slate; Quit"
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMinesweeperSlateBenchmarkTest, "Minesweeper.Benchmark.Slate", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FMinesweeperSlateBenchmarkTest::RunTest(const FString& Parameters)
+{
+	if (!FSlateApplication::IsInitialized())
+	{
+		AddError(TEXT("Slate is not initialized, the Slate benchmark needs an editor session"));
+		return false;
+	}
+
+	FMinesweeperBenchmarkReport Report(TEXT("Slate"));
+	FMinesweeperSlateBenchmark::Run(Report, *this);
+	Report.Finish(*this);
+
+	return !HasAnyErrors();
+}
+
+#endif
@@ -0,0 +1,79 @@
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Widgets/MinesweeperTileLabels.h"
+
+#include "Fonts/FontCache.h"
+#include "MinesweeperStats.h"
+#include "Framework/Application/SlateApplication.h"
+
+const FMinesweeperTileLabels& FMinesweeperTileLabels::Get()
+{
+	static const FMinesweeperTileLabels Instance;
+	return Instance;
+}
+
+FMinesweeperTileLabels::FMinesweeperTileLabels()
+	: Font(FAppStyle::Get().GetFontStyle("BoldFont"))
+{
+	LLM_SCOPE_BYTAG(Minesweeper_UI);
+
+	Labels[Empty].Color = FSlateColor::UseForeground();
+
+	for (int32 Count = 1; Count <= 8; ++Count)
+	{
+		Labels[Count].Text = FText::AsNumber(Count);
+	}
+
+	// Color code numbers based on count
+	Labels[1].Color = FSlateColor(FLinearColor(0.0f, 1.0f, 1.0f, 1.0f)); // Cyan
+	Labels[2].Color = FSlateColor(FLinearColor::Green);
+	Labels[3].Color = FSlateColor(FLinearColor::Yellow);
+	Labels[4].Color = FSlateColor(FLinearColor(1.0f, 0.5f, 0.0f, 1.0f)); // Orange
+	Labels[5].Color = FSlateColor(FLinearColor(1.0f, 0.7f, 0.7f, 1.0f)); // Pink
+	Labels[6].Color = FSlateColor(FLinearColor(0.5f, 0.0f, 0.5f, 1.0f)); // Purple
+	Labels[7].Color = FSlateColor(FLinearColor(0.5f, 0.0f, 0.0f, 1.0f)); // Maroon
+	Labels[8].Color = FSlateColor(FLinearColor::Red);
+
+	Labels[Flag].Text = FText::FromString(TEXT("🚩"));
+	Labels[Flag].Color = FSlateColor::UseForeground();
+
+	// Red color for revealed bombs
+	Labels[Bomb].Text = FText::FromString(TEXT("💣"));
+	Labels[Bomb].Color = FSlateColor(FLinearColor::Red);
+
+	const TSharedRef<FSlateFontCache> FontCache = FSlateApplication::Get().GetRenderer()->GetFontCache();
+	for (FLabel& Label : Labels)
+	{
+		Label.ShapedGlyphs = FontCache->ShapeBidirectionalText(Label.Text.ToString(), Font, 1.0f, TextBiDi::ETextDirection::LeftToRight, ETextShapingMethod::Auto);
+		Label.Size = FVector2f(Label.ShapedGlyphs->GetMeasuredWidth(), Label.ShapedGlyphs->GetMaxTextHeight());
+	}
+}
+
+FMinesweeperTileLabels::ELabel FMinesweeperTileLabels::GetLabelIndex(const EMinesweeperTileState State, const int32 AdjacentBombs)
+{
+	// Show flag if tile is flagged
+	if (EnumHasAnyFlags(State, EMinesweeperTileState::Flagged))
+		return Flag;
+
+	// Show nothing if not revealed
+	if (!EnumHasAnyFlags(State, EMinesweeperTileState::Revealed))
+		return Empty;
+
+	// Revealed bombs show the bomb, safe tiles their adjacent count (0 shows nothing)
+	return EnumHasAnyFlags(State, EMinesweeperTileState::Bomb) ? Bomb : static_cast<ELabel>(AdjacentBombs);
+}
+
+FLinearColor FMinesweeperTileLabels::GetBackgroundColor(const EMinesweeperTileState State)
+{
+	const bool bIsBomb = EnumHasAnyFlags(State, EMinesweeperTileState::Bomb);
+	const bool bIsRevealed = EnumHasAnyFlags(State, EMinesweeperTileState::Revealed);
+	const bool bIsFlagged = EnumHasAnyFlags(State, EMinesweeperTileState::Flagged);
+
+	// Red background for revealed bombs, and for flags revealed as wrong at the end of the game
+	if (bIsRevealed && bIsBomb != bIsFlagged)
+		return FLinearColor::Red;
+
+	// Dark gray for revealed tiles, default button color for unrevealed tiles
+	return bIsRevealed ? FLinearColor(0.3f, 0.3f, 0.3f, 1.0f) : FLinearColor(0.7f, 0.7f, 0.7f, 1.0f);
+}
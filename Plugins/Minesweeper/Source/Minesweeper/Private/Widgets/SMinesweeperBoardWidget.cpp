@@ -0,0 +1,542 @@
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
+
+
+#include "Widgets/SMinesweeperBoardWidget.h"
+
+#include "MinesweeperLatencyProbe.h"
+#include "MinesweeperLog.h"
+#include "MinesweeperStats.h"
+#include "Rendering/DrawElements.h"
+#include "Widgets/MinesweeperTileLabels.h"
+
+namespace MinesweeperBoardWidget
+{
+	const FLinearColor HoveredTileColor(0.85f, 0.85f, 0.85f, 1.0f);
+
+	/** Level of detail texels blend from hidden to revealed by their revealed share, flags pull them towards this */
+	const FLinearColor LodHiddenColor(0.7f, 0.7f, 0.7f, 1.0f);
+	const FLinearColor LodRevealedColor(0.3f, 0.3f, 0.3f, 1.0f);
+	const FLinearColor LodFlagColor(1.0f, 0.5f, 0.0f, 1.0f);
+
+	constexpr float WheelZoomFactor = 1.25f;
+}
+
+void SMinesweeperBoardWidget::Construct(const FArguments& InArgs)
+{
+	GameCoreWeak = InArgs._GameCore;
+	OnTileRevealed = InArgs._OnTileRevealed;
+	OnTileFlagged = InArgs._OnTileFlagged;
+
+	// Boards larger than the viewport are panned, never drawn outside of it
+	SetClipping(EWidgetClipping::ClipToBounds);
+}
+
+void SMinesweeperBoardWidget::SetGameCore(const TWeakPtr<FMinesweeperCore>& InGameCore)
+{
+	GameCoreWeak = InGameCore;
+	HoveredTileX = INDEX_NONE;
+	HoveredTileY = INDEX_NONE;
+	LodLevels.Reset();
+	StaleLodRows.Empty();
+	NumStaleLodRows = 0;
+
+	// A new board of the same size keeps the current view, so repeated games stay where the player was looking
+	const TSharedPtr<FMinesweeperCore> GameCore = GameCoreWeak.Pin();
+	const int32 BoardWidth = GameCore.IsValid() ? GameCore->GetBoard().GetWidth() : 0;
+	const int32 BoardHeight = GameCore.IsValid() ? GameCore->GetBoard().GetHeight() : 0;
+	if (BoardWidth != ViewBoardWidth || BoardHeight != ViewBoardHeight)
+	{
+		ViewBoardWidth = BoardWidth;
+		ViewBoardHeight = BoardHeight;
+		ViewOrigin = FVector2f::ZeroVector;
+		TilePitch = TileSize;
+	}
+
+	Invalidate(EInvalidateWidgetReason::Layout);
+}
+
+void SMinesweeperBoardWidget::ApplyChangeSet(const FMinesweeperChangeSet& ChangeSet)
+{
+	Invalidate(EInvalidateWidgetReason::Paint);
+
+	// Without a pyramid there is nothing to keep in sync, it is built from the board when first needed
+	const TSharedPtr<FMinesweeperCore> GameCore = GameCoreWeak.Pin();
+	if (LodLevels.IsEmpty() || !GameCore.IsValid())
+		return;
+
+	const FMinesweeperBoard& Board = GameCore->GetBoard();
+	for (const FMinesweeperTileChange& TileChange : ChangeSet.TileChanges)
+	{
+		const int32 Y = TileChange.TileIndex / Board.GetWidth();
+		MarkLodRowsStale(Y, Y);
+	}
+
+	// Lanes of a plane word run in row order, so the lowest and highest revealed lane bound its rows
+	for (const FMinesweeperRevealedCells& RevealedCells : ChangeSet.RevealedCells)
+	{
+		int32 X, FirstY, LastY;
+		Board.GetCellCoordinates(RevealedCells.WordIndex * 64 + static_cast<int32>(FMath::CountTrailingZeros64(RevealedCells.CellMask)), X, FirstY);
+		Board.GetCellCoordinates(RevealedCells.WordIndex * 64 + 63 - static_cast<int32>(FMath::CountLeadingZeros64(RevealedCells.CellMask)), X, LastY);
+		MarkLodRowsStale(FirstY, LastY);
+	}
+}
+
+bool SMinesweeperBoardWidget::RefreshLevelOfDetail(const double EndTime)
+{
+	MS_SCOPE_CYCLE_COUNTER(STAT_Minesweeper_RefreshLevelOfDetail);
+
+	if (NumStaleLodRows == 0)
+		return true;
+
+	const TSharedPtr<FMinesweeperCore> GameCore = GameCoreWeak.Pin();
+	if (!GameCore.IsValid())
+	{
+		StaleLodRows.Init(false, StaleLodRows.Num());
+		NumStaleLodRows = 0;
+		return true;
+	}
+
+	// Counts are read back from the board, so a row marked by several change sets is only recounted once
+	do
+	{
+		const int32 TexelY = StaleLodRows.Find(true);
+		StaleLodRows[TexelY] = false;
+		--NumStaleLodRows;
+
+		CountLodRow(GameCore->GetBoard(), TexelY);
+		for (int32 Level = 1; Level < LodLevels.Num(); ++Level)
+		{
+			SumLodRow(Level, TexelY >> Level);
+		}
+	}
+	while (NumStaleLodRows > 0 && FPlatformTime::Seconds() < EndTime);
+
+	Invalidate(EInvalidateWidgetReason::Paint);
+	return NumStaleLodRows == 0;
+}
+
+void SMinesweeperBoardWidget::MarkLodRowsStale(const int32 FirstY, const int32 LastY)
+{
+	for (int32 TexelY = FirstY / LodBaseBlockSize; TexelY <= LastY / LodBaseBlockSize; ++TexelY)
+	{
+		if (!StaleLodRows[TexelY])
+		{
+			StaleLodRows[TexelY] = true;
+			++NumStaleLodRows;
+		}
+	}
+}
+
+SIZE_T SMinesweeperBoardWidget::GetAllocatedSize() const
+{
+	SIZE_T AllocatedSize = sizeof(*this) + LodLevels.GetAllocatedSize() + StaleLodRows.GetAllocatedSize();
+	for (const FLodLevel& LodLevel : LodLevels)
+	{
+		AllocatedSize += LodLevel.Texels.GetAllocatedSize();
+	}
+
+	return AllocatedSize;
+}
+
+SIZE_T SMinesweeperBoardWidget::GetMaxAllocatedSize(const int32 BoardWidth, const int32 BoardHeight)
+{
+	SIZE_T AllocatedSize = sizeof(SMinesweeperBoardWidget) + NumLodLevels * sizeof(FLodLevel) + FMath::DivideAndRoundUp(BoardHeight, LodBaseBlockSize * 8);
+	for (int32 Level = 0; Level < NumLodLevels; ++Level)
+	{
+		const int32 BlockSize = LodBaseBlockSize << Level;
+		AllocatedSize += SIZE_T(FMath::DivideAndRoundUp(BoardWidth, BlockSize)) * FMath::DivideAndRoundUp(BoardHeight, BlockSize) * sizeof(FLodTexel);
+	}
+
+	return AllocatedSize;
+}
+
+// ==== Painting
+
+int32 SMinesweeperBoardWidget::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	MS_SCOPE_CYCLE_COUNTER(STAT_Minesweeper_PaintBoard);
+	FMinesweeperLatencyProbe::MarkPainted();
+
+	const TSharedPtr<FMinesweeperCore> GameCore = GameCoreWeak.Pin();
+	if (!GameCore.IsValid())
+		return LayerId;
+
+	// Only the part of the viewport the culling rect overlaps is painted
+	const FVector2D CullTopLeft = AllottedGeometry.AbsoluteToLocal(MyCullingRect.GetTopLeft());
+	const FVector2D CullBottomRight = AllottedGeometry.AbsoluteToLocal(MyCullingRect.GetBottomRight());
+	const FSlateRect LocalViewRect = FSlateRect(FVector2D::ZeroVector, AllottedGeometry.GetLocalSize()).IntersectionWith(FSlateRect(CullTopLeft, CullBottomRight));
+
+	const bool bEnabled = ShouldBeEnabled(bParentEnabled);
+	return IsShowingTiles()
+		? PaintTiles(*GameCore, AllottedGeometry, LocalViewRect, OutDrawElements, LayerId, InWidgetStyle, bEnabled)
+		: PaintLevelOfDetail(*GameCore, AllottedGeometry, LocalViewRect, OutDrawElements, LayerId, InWidgetStyle, bEnabled);
+}
+
+int32 SMinesweeperBoardWidget::PaintTiles(const FMinesweeperCore& GameCore, const FGeometry& AllottedGeometry, const FSlateRect& LocalViewRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, const bool bEnabled) const
+{
+	const FMinesweeperBoard& Board = GameCore.GetBoard();
+	const int32 FirstX = FMath::Clamp(FMath::FloorToInt(ViewOrigin.X + LocalViewRect.Left / TilePitch), 0, Board.GetWidth());
+	const int32 FirstY = FMath::Clamp(FMath::FloorToInt(ViewOrigin.Y + LocalViewRect.Top / TilePitch), 0, Board.GetHeight());
+	const int32 EndX = FMath::Clamp(FMath::CeilToInt(ViewOrigin.X + LocalViewRect.Right / TilePitch), 0, Board.GetWidth());
+	const int32 EndY = FMath::Clamp(FMath::CeilToInt(ViewOrigin.Y + LocalViewRect.Bottom / TilePitch), 0, Board.GetHeight());
+
+	const ESlateDrawEffect DrawEffect = bEnabled ? ESlateDrawEffect::None : ESlateDrawEffect::DisabledEffect;
+	const bool bCanHover = bEnabled && GameCore.IsGameActive();
+
+	// Tiles use the regular button brush, tinted like the tile buttons were. Tiny tiles can't show the rounded corners anyway.
+	const FSlateBrush* TileBrush = TilePitch >= MinLabelTilePitch ? &FAppStyle::Get().GetWidgetStyle<FButtonStyle>("Button").Normal : FAppStyle::GetBrush("WhiteBrush");
+	const FMinesweeperTileLabels& TileLabels = FMinesweeperTileLabels::Get();
+	const bool bShowLabels = TilePitch >= MinLabelTilePitch;
+	const FLinearColor LabelOutlineColor = TileLabels.GetFont().OutlineSettings.OutlineColor * InWidgetStyle.GetColorAndOpacityTint();
+
+	// Tiles are laid out at their default size and scaled to the zoom, so labels scale with them
+	const float TileScale = TilePitch / TileSize;
+	const FVector2f TileDrawSize(TileSize - TileGap, TileSize - TileGap);
+
+	// Boxes and labels go on two layers, so each layer is drawn as a single batch
+	const int32 TileLayerId = LayerId;
+	const int32 LabelLayerId = LayerId + 1;
+
+	INC_DWORD_STAT_BY(STAT_Minesweeper_TilesPainted, (EndX - FirstX) * (EndY - FirstY));
+	for (int32 Y = FirstY; Y < EndY; ++Y)
+	{
+		for (int32 X = FirstX; X < EndX; ++X)
+		{
+			const int32 CellIndex = Board.GetCellIndex(X, Y);
+			const EMinesweeperTileState State = Board.GetTileState(CellIndex);
+			const FSlateLayoutTransform TileTransform(TileScale, (FVector2f(X, Y) - ViewOrigin) * TilePitch);
+
+			const bool bHovered = bCanHover && X == HoveredTileX && Y == HoveredTileY && !EnumHasAnyFlags(State, EMinesweeperTileState::Revealed);
+			const FLinearColor TileColor = bHovered ? MinesweeperBoardWidget::HoveredTileColor : FMinesweeperTileLabels::GetBackgroundColor(State);
+
+			FSlateDrawElement::MakeBox(
+				OutDrawElements,
+				TileLayerId,
+				AllottedGeometry.ToPaintGeometry(TileDrawSize, TileTransform),
+				TileBrush,
+				DrawEffect,
+				TileColor * InWidgetStyle.GetColorAndOpacityTint());
+
+			if (!bShowLabels)
+				continue;
+
+			const FMinesweeperTileLabels::ELabel LabelIndex = FMinesweeperTileLabels::GetLabelIndex(State, Board.GetAdjacentBombs(CellIndex));
+			if (LabelIndex == FMinesweeperTileLabels::Empty)
+				continue;
+
+			const FMinesweeperTileLabels::FLabel& Label = TileLabels.GetLabel(LabelIndex);
+			FSlateDrawElement::MakeShapedText(
+				OutDrawElements,
+				LabelLayerId,
+				AllottedGeometry.ToPaintGeometry(TileDrawSize, Concatenate(FSlateLayoutTransform((TileDrawSize - Label.Size) * 0.5f), TileTransform)),
+				Label.ShapedGlyphs.ToSharedRef(),
+				DrawEffect,
+				Label.Color.GetColor(InWidgetStyle) * InWidgetStyle.GetColorAndOpacityTint(),
+				LabelOutlineColor);
+		}
+	}
+
+	return LabelLayerId;
+}
+
+int32 SMinesweeperBoardWidget::PaintLevelOfDetail(const FMinesweeperCore& GameCore, const FGeometry& AllottedGeometry, const FSlateRect& LocalViewRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, const bool bEnabled) const
+{
+	using namespace MinesweeperBoardWidget;
+
+	if (LodLevels.IsEmpty())
+	{
+		BuildLodPyramid(GameCore);
+	}
+
+	// Finest level whose texels are still a few units wide, so the texel count is bounded by the viewport size
+	int32 Level = 0;
+	while (Level < NumLodLevels - 1 && (LodBaseBlockSize << Level) * TilePitch < MinLodTexelPitch)
+	{
+		++Level;
+	}
+
+	const FLodLevel& LodLevel = LodLevels[Level];
+	const int32 BlockSize = LodBaseBlockSize << Level;
+	const float TexelPitch = BlockSize * TilePitch;
+	const FVector2f TexelOrigin = ViewOrigin / BlockSize;
+
+	const int32 FirstX = FMath::Clamp(FMath::FloorToInt(TexelOrigin.X + LocalViewRect.Left / TexelPitch), 0, LodLevel.Width);
+	const int32 FirstY = FMath::Clamp(FMath::FloorToInt(TexelOrigin.Y + LocalViewRect.Top / TexelPitch), 0, LodLevel.Height);
+	const int32 EndX = FMath::Clamp(FMath::CeilToInt(TexelOrigin.X + LocalViewRect.Right / TexelPitch), 0, LodLevel.Width);
+	const int32 EndY = FMath::Clamp(FMath::CeilToInt(TexelOrigin.Y + LocalViewRect.Bottom / TexelPitch), 0, LodLevel.Height);
+
+	const FSlateBrush* TexelBrush = FAppStyle::GetBrush("WhiteBrush");
+	const ESlateDrawEffect DrawEffect = bEnabled ? ESlateDrawEffect::None : ESlateDrawEffect::DisabledEffect;
+	const int32 BoardWidth = GameCore.GetBoard().GetWidth();
+	const int32 BoardHeight = GameCore.GetBoard().GetHeight();
+
+	for (int32 Y = FirstY; Y < EndY; ++Y)
+	{
+		for (int32 X = FirstX; X < EndX; ++X)
+		{
+			// Texels on the right and bottom edges only partly cover the board
+			const int32 TexelTilesX = FMath::Min(BlockSize, BoardWidth - X * BlockSize);
+			const int32 TexelTilesY = FMath::Min(BlockSize, BoardHeight - Y * BlockSize);
+			const float TexelTiles = float(TexelTilesX * TexelTilesY);
+
+			const FLodTexel& Texel = LodLevel.Texels[Y * LodLevel.Width + X];
+			FLinearColor TexelColor = FMath::Lerp(LodHiddenColor, LodRevealedColor, Texel.Revealed / TexelTiles);
+			if (Texel.Flagged > 0)
+			{
+				// Flags are rare, any flag in the texel must stay visible
+				TexelColor = FMath::Lerp(TexelColor, LodFlagColor, FMath::Min(1.0f, 0.5f + Texel.Flagged / TexelTiles));
+			}
+
+			FSlateDrawElement::MakeBox(
+				OutDrawElements,
+				LayerId,
+				AllottedGeometry.ToPaintGeometry(FVector2f(TexelTilesX, TexelTilesY) * TilePitch, FSlateLayoutTransform((FVector2f(X, Y) - TexelOrigin) * TexelPitch)),
+				TexelBrush,
+				DrawEffect,
+				TexelColor * InWidgetStyle.GetColorAndOpacityTint());
+		}
+	}
+
+	return LayerId;
+}
+
+void SMinesweeperBoardWidget::BuildLodPyramid(const FMinesweeperCore& GameCore) const
+{
+	LLM_SCOPE_BYTAG(Minesweeper_UI);
+
+	const FMinesweeperBoard& Board = GameCore.GetBoard();
+
+	LodLevels.SetNum(NumLodLevels);
+	for (int32 Level = 0; Level < NumLodLevels; ++Level)
+	{
+		const int32 BlockSize = LodBaseBlockSize << Level;
+		LodLevels[Level].Width = FMath::DivideAndRoundUp(Board.GetWidth(), BlockSize);
+		LodLevels[Level].Height = FMath::DivideAndRoundUp(Board.GetHeight(), BlockSize);
+		LodLevels[Level].Texels.SetNumZeroed(LodLevels[Level].Width * LodLevels[Level].Height);
+	}
+
+	// Built from the board as it is now, so nothing marked before is stale any more
+	StaleLodRows.Init(false, LodLevels[0].Height);
+	NumStaleLodRows = 0;
+
+	// A fresh game has nothing revealed or flagged, the zeroed pyramid is already right
+	if (GameCore.GetRevealedTileCount() == 0 && GameCore.GetFlaggedTileCount() == 0)
+		return;
+
+	for (int32 TexelY = 0; TexelY < LodLevels[0].Height; ++TexelY)
+	{
+		CountLodRow(Board, TexelY);
+	}
+
+	for (int32 Level = 1; Level < NumLodLevels; ++Level)
+	{
+		for (int32 TexelY = 0; TexelY < LodLevels[Level].Height; ++TexelY)
+		{
+			SumLodRow(Level, TexelY);
+		}
+	}
+}
+
+void SMinesweeperBoardWidget::CountLodRow(const FMinesweeperBoard& Board, const int32 TexelY) const
+{
+	FLodLevel& BaseLevel = LodLevels[0];
+	FLodTexel* TexelRow = &BaseLevel.Texels[TexelY * BaseLevel.Width];
+	FMemory::Memzero(TexelRow, BaseLevel.Width * sizeof(FLodTexel));
+
+	const int32 EndY = FMath::Min((TexelY + 1) * LodBaseBlockSize, Board.GetHeight());
+	for (int32 Y = TexelY * LodBaseBlockSize; Y < EndY; ++Y)
+	{
+		for (int32 X = 0; X < Board.GetWidth(); ++X)
+		{
+			const int32 CellIndex = Board.GetCellIndex(X, Y);
+			TexelRow[X / LodBaseBlockSize].Revealed += Board.IsRevealed(CellIndex) ? 1 : 0;
+			TexelRow[X / LodBaseBlockSize].Flagged += Board.IsFlagged(CellIndex) ? 1 : 0;
+		}
+	}
+}
+
+void SMinesweeperBoardWidget::SumLodRow(const int32 Level, const int32 TexelY) const
+{
+	const FLodLevel& Source = LodLevels[Level - 1];
+	FLodLevel& Target = LodLevels[Level];
+
+	// Texels on the right and bottom edges have fewer than 2x2 texels below them
+	const int32 EndSourceY = FMath::Min(TexelY * 2 + 2, Source.Height);
+	for (int32 X = 0; X < Target.Width; ++X)
+	{
+		FLodTexel Sum;
+		const int32 EndSourceX = FMath::Min(X * 2 + 2, Source.Width);
+		for (int32 SourceY = TexelY * 2; SourceY < EndSourceY; ++SourceY)
+		{
+			for (int32 SourceX = X * 2; SourceX < EndSourceX; ++SourceX)
+			{
+				Sum.Revealed += Source.Texels[SourceY * Source.Width + SourceX].Revealed;
+				Sum.Flagged += Source.Texels[SourceY * Source.Width + SourceX].Flagged;
+			}
+		}
+		Target.Texels[TexelY * Target.Width + X] = Sum;
+	}
+}
+
+// ==== Input
+
+FReply SMinesweeperBoardWidget::OnMouseButtonDown(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
+{
+	if (MouseEvent.GetEffectingButton() == EKeys::MiddleMouseButton)
+	{
+		bIsPanning = true;
+		LastPanPosition = FVector2f(MouseEvent.GetScreenSpacePosition());
+		return FReply::Handled().CaptureMouse(SharedThis(this));
+	}
+
+	const TSharedPtr<FMinesweeperCore> GameCore = GameCoreWeak.Pin();
+	if (!GameCore.IsValid() || !GameCore->IsGameActive())
+		return FReply::Unhandled();
+
+	int32 X, Y;
+	if (!GetTileAtScreenPosition(MyGeometry, MouseEvent.GetScreenSpacePosition(), X, Y))
+		return FReply::Unhandled();
+
+	// Single tiles can't be told apart when zoomed out that far, a click zooms back in on them instead
+	if (!IsShowingTiles())
+	{
+		const FVector2f ViewSize(MyGeometry.GetLocalSize());
+		SetTilePitch(TileSize, FVector2f(MyGeometry.AbsoluteToLocal(MouseEvent.GetScreenSpacePosition())), ViewSize);
+		return FReply::Handled();
+	}
+
+	// Revealed tiles take no input, same as the disabled tile buttons
+	if (GameCore->GetBoard().IsRevealed(GameCore->GetBoard().GetCellIndex(X, Y)))
+		return FReply::Handled();
+
+	if (MouseEvent.GetEffectingButton() == EKeys::LeftMouseButton && OnTileRevealed.IsBound())
+	{
+		FMinesweeperLatencyProbe::BeginInteraction(EMinesweeperLatencyOperation::Reveal);
+		MS_MOVE_DISPLAY("Left click on tile [%d, %d]", X, Y);
+		OnTileRevealed.Execute(X, Y);
+		return FReply::Handled();
+	}
+
+	if (MouseEvent.GetEffectingButton() == EKeys::RightMouseButton && OnTileFlagged.IsBound())
+	{
+		FMinesweeperLatencyProbe::BeginInteraction(EMinesweeperLatencyOperation::Flag);
+		MS_MOVE_DISPLAY("Right click on tile [%d, %d]", X, Y);
+		OnTileFlagged.Execute(X, Y);
+		return FReply::Handled();
+	}
+
+	return FReply::Unhandled();
+}
+
+FReply SMinesweeperBoardWidget::OnMouseButtonUp(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
+{
+	if (bIsPanning && MouseEvent.GetEffectingButton() == EKeys::MiddleMouseButton)
+	{
+		bIsPanning = false;
+		return FReply::Handled().ReleaseMouseCapture();
+	}
+
+	return FReply::Unhandled();
+}
+
+FReply SMinesweeperBoardWidget::OnMouseMove(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
+{
+	if (bIsPanning && HasMouseCapture())
+	{
+		const FVector2f PanPosition(MouseEvent.GetScreenSpacePosition());
+		const FVector2f LocalDelta = (PanPosition - LastPanPosition) / MyGeometry.Scale;
+		LastPanPosition = PanPosition;
+
+		ViewOrigin -= LocalDelta / TilePitch;
+		ClampView(FVector2f(MyGeometry.GetLocalSize()));
+		Invalidate(EInvalidateWidgetReason::Paint);
+		return FReply::Handled();
+	}
+
+	int32 X, Y;
+	if (!IsShowingTiles() || !GetTileAtScreenPosition(MyGeometry, MouseEvent.GetScreenSpacePosition(), X, Y))
+	{
+		X = INDEX_NONE;
+		Y = INDEX_NONE;
+	}
+
+	if (X != HoveredTileX || Y != HoveredTileY)
+	{
+		HoveredTileX = X;
+		HoveredTileY = Y;
+		Invalidate(EInvalidateWidgetReason::Paint);
+	}
+
+	return FReply::Unhandled();
+}
+
+FReply SMinesweeperBoardWidget::OnMouseWheel(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
+{
+	const float NewTilePitch = TilePitch * FMath::Pow(MinesweeperBoardWidget::WheelZoomFactor, MouseEvent.GetWheelDelta());
+	SetTilePitch(NewTilePitch, FVector2f(MyGeometry.AbsoluteToLocal(MouseEvent.GetScreenSpacePosition())), FVector2f(MyGeometry.GetLocalSize()));
+	return FReply::Handled();
+}
+
+void SMinesweeperBoardWidget::OnMouseLeave(const FPointerEvent& MouseEvent)
+{
+	SLeafWidget::OnMouseLeave(MouseEvent);
+
+	HoveredTileX = INDEX_NONE;
+	HoveredTileY = INDEX_NONE;
+	Invalidate(EInvalidateWidgetReason::Paint);
+}
+
+// ==== View
+
+FVector2D SMinesweeperBoardWidget::ComputeDesiredSize(float LayoutScaleMultiplier) const
+{
+	const TSharedPtr<FMinesweeperCore> GameCore = GameCoreWeak.Pin();
+	if (!GameCore.IsValid())
+		return FVector2D::ZeroVector;
+
+	// Small boards are shown whole at the default zoom, larger ones get a fixed size viewport
+	const FMinesweeperBoard& Board = GameCore->GetBoard();
+	return FVector2D(FMath::Min(Board.GetWidth() * TileSize, MaxDesiredViewSize), FMath::Min(Board.GetHeight() * TileSize, MaxDesiredViewSize));
+}
+
+bool SMinesweeperBoardWidget::GetTileAtScreenPosition(const FGeometry& MyGeometry, const FVector2D& ScreenPosition, int32& OutX, int32& OutY) const
+{
+	const TSharedPtr<FMinesweeperCore> GameCore = GameCoreWeak.Pin();
+	if (!GameCore.IsValid())
+		return false;
+
+	const FVector2f BoardPosition = ViewOrigin + FVector2f(MyGeometry.AbsoluteToLocal(ScreenPosition)) / TilePitch;
+	OutX = FMath::FloorToInt(BoardPosition.X);
+	OutY = FMath::FloorToInt(BoardPosition.Y);
+	return GameCore->IsValidCoordinate(OutX, OutY);
+}
+
+float SMinesweeperBoardWidget::GetFitTilePitch(const FVector2f& ViewSize) const
+{
+	if (ViewBoardWidth <= 0 || ViewBoardHeight <= 0)
+		return TileSize;
+
+	return FMath::Min(ViewSize.X / ViewBoardWidth, ViewSize.Y / ViewBoardHeight);
+}
+
+void SMinesweeperBoardWidget::SetTilePitch(const float NewTilePitch, const FVector2f& LocalAnchor, const FVector2f& ViewSize)
+{
+	// Zooming out stops once the whole board is visible, small boards never zoom out past the default size
+	const float MinTilePitch = FMath::Min(GetFitTilePitch(ViewSize), TileSize);
+	const float ClampedTilePitch = FMath::Clamp(NewTilePitch, MinTilePitch, MaxTilePitch);
+
+	const FVector2f AnchorOnBoard = ViewOrigin + LocalAnchor / TilePitch;
+	TilePitch = ClampedTilePitch;
+	ViewOrigin = AnchorOnBoard - LocalAnchor / TilePitch;
+
+	ClampView(ViewSize);
+	HoveredTileX = INDEX_NONE;
+	HoveredTileY = INDEX_NONE;
+	Invalidate(EInvalidateWidgetReason::Paint);
+}
+
+void SMinesweeperBoardWidget::ClampView(const FVector2f& ViewSize)
+{
+	const FVector2f MaxOrigin = (FVector2f(ViewBoardWidth, ViewBoardHeight) - ViewSize / TilePitch).ComponentMax(FVector2f::ZeroVector);
+	ViewOrigin = ViewOrigin.ComponentMin(MaxOrigin).ComponentMax(FVector2f::ZeroVector);
+}
@@ -3,17 +3,27 @@
 
 #include "Widgets/SMinesweeperTileButton.h"
 
+#include "MinesweeperLatencyProbe.h"
 #include "MinesweeperLog.h"
+#include "MinesweeperStats.h"
+#include "Widgets/MinesweeperTileLabels.h"
 #include "SlateOptMacros.h"
+#include "Widgets/Layout/SUniformGridPanel.h"
 
 BEGIN_SLATE_FUNCTION_BUILD_OPTIMIZATION
 
+SMinesweeperTileButton::~SMinesweeperTileButton()
+{
+	DEC_DWORD_STAT(STAT_Minesweeper_TileWidgetsAlive);
+}
+
 void SMinesweeperTileButton::Construct(const FArguments& InArgs)
 {
-	// Store tile coordinates and game reference
+	INC_DWORD_STAT(STAT_Minesweeper_TileWidgetsAlive);
+
+	// Store tile coordinates
 	TileX = InArgs._TileX;
 	TileY = InArgs._TileY;
-	GameCoreWeak = InArgs._GameCore;
 
 	// Store event delegates
 	OnTileRevealed = InArgs._OnTileRevealed;
@@ -23,7 +33,7 @@ void SMinesweeperTileButton::Construct(const FArguments& InArgs)
 	SButton::FArguments ButtonArgs;
 	ButtonArgs.ClickMethod(InArgs._ClickMethod);
 	ButtonArgs.OnClicked_Raw(this, &SMinesweeperTileButton::ExecuteOnLeftClick);
-	ButtonArgs.ButtonColorAndOpacity(this, &SMinesweeperTileButton::GetTileBackgroundColor);
+	ButtonArgs.ButtonColorAndOpacity(FMinesweeperTileLabels::GetBackgroundColor(TileState));
 	ButtonArgs.HAlign(InArgs._HAlign);
 	ButtonArgs.VAlign(InArgs._VAlign);
 	ButtonArgs.Content()
@@ -32,10 +42,8 @@ void SMinesweeperTileButton::Construct(const FArguments& InArgs)
 		.WidthOverride(20)
 		.HeightOverride(20)
 		[
-			SNew(STextBlock)
-			.Text(this, &SMinesweeperTileButton::GetTileDisplayText)
-			.ColorAndOpacity(this, &SMinesweeperTileButton::GetTileTextColor)
-			.Font(FAppStyle::Get().GetFontStyle("BoldFont"))
+			SAssignNew(TileTextBlock, STextBlock)
+			.Font(FMinesweeperTileLabels::Get().GetFont())
 			.Justification(ETextJustify::Center)
 		]
 	];
@@ -44,6 +52,37 @@ void SMinesweeperTileButton::Construct(const FArguments& InArgs)
 	SButton::Construct(ButtonArgs);
 }
 
+void SMinesweeperTileButton::SetTileCoordinates(const int32 InTileX, const int32 InTileY)
+{
+	TileX = InTileX;
+	TileY = InTileY;
+}
+
+void SMinesweeperTileButton::SetTileState(const EMinesweeperTileState InState, const int32 InAdjacentBombs, const bool bInteractable)
+{
+	// Plain values rather than bound attributes, the setters only invalidate when a value actually changes
+	SetEnabled(bInteractable);
+
+	if (bHasTileState && InState == TileState && InAdjacentBombs == AdjacentBombs)
+		return;
+
+	TileState = InState;
+	AdjacentBombs = InAdjacentBombs;
+	bHasTileState = true;
+	bStateChangedSincePaint = true;
+
+	// Labels come from the shared table, copying them only bumps reference counts
+	const FMinesweeperTileLabels::FLabel& Label = FMinesweeperTileLabels::Get().GetLabel(TileState, AdjacentBombs);
+	SetBorderBackgroundColor(FMinesweeperTileLabels::GetBackgroundColor(TileState));
+	TileTextBlock->SetText(Label.Text);
+	TileTextBlock->SetColorAndOpacity(Label.Color);
+}
+
+SIZE_T SMinesweeperTileButton::GetEstimatedTileSize()
+{
+	return sizeof(SMinesweeperTileButton) + sizeof(SBox) + sizeof(STextBlock) + sizeof(SUniformGridPanel::FSlot);
+}
+
 FReply SMinesweeperTileButton::OnMouseButtonDown(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
 {
 	// Support handling Mouse Right Click, this is used for Minesweeper right click game play feature.
@@ -70,9 +109,22 @@ FReply SMinesweeperTileButton::OnMouseButtonUp(const FGeometry& MyGeometry, cons
 	return SButton::OnMouseButtonUp(MyGeometry, MouseEvent);
 }
 
+int32 SMinesweeperTileButton::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	// Hover, press and layout repaint buttons too, only the paint of a button the update changed shows the result of a click
+	if (bStateChangedSincePaint)
+	{
+		bStateChangedSincePaint = false;
+		FMinesweeperLatencyProbe::MarkPainted();
+	}
+
+	return SButton::OnPaint(Args, AllottedGeometry, MyCullingRect, OutDrawElements, LayerId, InWidgetStyle, bParentEnabled);
+}
+
 FReply SMinesweeperTileButton::ExecuteOnLeftClick() const
 {
-	MS_DISPLAY("Left click on tile [%d, %d]", TileX, TileY);
+	FMinesweeperLatencyProbe::BeginInteraction(EMinesweeperLatencyOperation::Reveal);
+	MS_MOVE_DISPLAY("Left click on tile [%d, %d]", TileX, TileY);
 
 	PlayClickedSound();
 
@@ -87,7 +139,8 @@ FReply SMinesweeperTileButton::ExecuteOnLeftClick() const
 
 FReply SMinesweeperTileButton::ExecuteOnRightClick() const
 {
-	MS_DISPLAY("Right click on tile [%d, %d]", TileX, TileY);
+	FMinesweeperLatencyProbe::BeginInteraction(EMinesweeperLatencyOperation::Flag);
+	MS_MOVE_DISPLAY("Right click on tile [%d, %d]", TileX, TileY);
 
 	PlayClickedSound();
 
@@ -100,106 +153,4 @@ FReply SMinesweeperTileButton::ExecuteOnRightClick() const
 	return FReply::Unhandled();
 }
 
-FText SMinesweeperTileButton::GetTileDisplayText() const
-{
-	const FMinesweeperTile* TileData = GetCurrentTileData();
-	if (TileData == nullptr)
-		return FText::GetEmpty();
-
-	// Show flag if tile is flagged
-	if (TileData->bIsFlagged)
-		return FText::FromString(TEXT("🚩"));
-
-	// Show nothing if not revealed
-	if (!TileData->bIsRevealed)
-		return FText::GetEmpty();
-
-	// Show bomb if revealed and is bomb
-	if (TileData->bIsBomb)
-		return FText::FromString(TEXT("💣"));
-
-	// Show number if there are adjacent bombs
-	if (TileData->AdjacentBombs > 0)
-		return FText::AsNumber(TileData->AdjacentBombs);
-
-	// Empty for revealed safe tiles with no adjacent bombs
-	return FText::GetEmpty();
-}
-
-FSlateColor SMinesweeperTileButton::GetTileTextColor() const
-{
-	const FMinesweeperTile* TileData = GetCurrentTileData();
-	if (TileData == nullptr)
-		return FSlateColor::UseForeground();
-
-	// Red color for revealed bombs
-	if (TileData->bIsBomb && TileData->bIsRevealed)
-		return FSlateColor(FLinearColor::Red);
-
-	// Color code numbers based on adjacent bomb count
-	if (TileData->bIsRevealed && TileData->AdjacentBombs > 0)
-		return GetTileTextColorBasedOnAdjacentBomb(TileData->AdjacentBombs);
-
-	return FSlateColor::UseForeground();
-}
-
-FSlateColor SMinesweeperTileButton::GetTileBackgroundColor() const
-{
-	const FMinesweeperTile* TileData = GetCurrentTileData();
-	if (TileData == nullptr)
-		return FSlateColor::UseForeground();
-
-	// Red background for revealed bombs (not flagged)
-	if (TileData->bIsBomb && TileData->bIsRevealed && !TileData->bIsFlagged)
-		return FSlateColor(FLinearColor::Red);
-
-	// Red background for incorrectly flagged tiles (flagged but not a bomb, and revealed)
-	if (TileData->bIsFlagged && TileData->bIsRevealed && !TileData->bIsBomb)
-		return FSlateColor(FLinearColor::Red);
-
-	// Dark gray for revealed tiles
-	if (TileData->bIsRevealed)
-		return FSlateColor(FLinearColor(0.3f, 0.3f, 0.3f, 1.0f));
-
-	// Default button color for unrevealed tiles
-	return FSlateColor(FLinearColor(0.7f, 0.7f, 0.7f, 1.0f));
-}
-
-FSlateColor SMinesweeperTileButton::GetTileTextColorBasedOnAdjacentBomb(const int32 AdjacentBombCount) const
-{
-	// Color code numbers based on count
-	switch (AdjacentBombCount)
-	{
-		case 1:
-			return FSlateColor(FLinearColor(0.0f, 1.0f, 1.0f, 1.0f)); // Cyan
-		case 2:
-			return FSlateColor(FLinearColor::Green);
-		case 3:
-			return FSlateColor(FLinearColor::Yellow);
-		case 4:
-			return FSlateColor(FLinearColor(1.0f, 0.5f, 0.0f, 1.0f)); // Orange
-		case 5:
-			return FSlateColor(FLinearColor(1.0f, 0.7f, 0.7f, 1.0f)); // Pink
-		case 6:
-			return FSlateColor(FLinearColor(0.5f, 0.0f, 0.5f, 1.0f)); // Purple
-		case 7:
-			return FSlateColor(FLinearColor(0.5f, 0.0f, 0.0f, 1.0f)); // Maroon
-		case 8:
-			return FSlateColor(FLinearColor::Red);
-		default:
-			return FSlateColor::UseForeground();
-	}
-}
-
-const FMinesweeperTile* SMinesweeperTileButton::GetCurrentTileData() const
-{
-	const TSharedPtr<FMinesweeperCore> GameCore = GameCoreWeak.Pin();
-	if (!GameCore.IsValid())
-	{
-		return nullptr;
-	}
-
-	return GameCore->GetTile(TileX, TileY);
-}
-
 END_SLATE_FUNCTION_BUILD_OPTIMIZATION
@@ -2,16 +2,151 @@
 
 #include "Widgets/SMinesweeperWidget.h"
 
+#include "MinesweeperLatencyProbe.h"
 #include "MinesweeperLog.h"
+#include "MinesweeperStats.h"
+#include "Widgets/SMinesweeperBoardWidget.h"
 #include "Widgets/SMinesweeperTileButton.h"
 
+#include "HAL/IConsoleManager.h"
 #include "SlateOptMacros.h"
+#include "Widgets/Input/SCheckBox.h"
 #include "Widgets/Layout/SUniformGridPanel.h"
+#include "Widgets/SInvalidationPanel.h"
+
+// Boards above this many tiles are not built as one button per tile
+static constexpr int32 MineSweeperMaxTileWidgets = 100 * 100;
+
+static TAutoConsoleVariable<int32> CVarMinesweeperBoardView(
+	TEXT("Minesweeper.BoardView"),
+	0,
+	TEXT("How the board is displayed, applied on the next new game.\n")
+	TEXT("0: single painted board widget (default)\n")
+	TEXT("1: legacy grid of one button per tile"));
+
+static TAutoConsoleVariable<float> CVarMinesweeperViewUpdateBudgetMs(
+	TEXT("Minesweeper.ViewUpdateBudgetMs"),
+	2.0f,
+	TEXT("Time per frame spent bringing the board view up to date: the level of detail of the painted board, or the tile buttons. Large openings are shown over several frames, the game itself is always up to date."));
+
+// Change sets up to this many tiles are applied to the tile buttons right away, bigger ones are time sliced
+static constexpr int32 MineSweeperImmediateTileChanges = 4096;
+
+// Tile changes applied between two budget checks
+static constexpr int32 MineSweeperTileChangesPerBudgetCheck = 1024;
+
+// Spin box settings must stay unchanged this long before a game is prefetched for them, dragging a value would start a generation every tick
+static constexpr float MineSweeperPrefetchIdleSeconds = 0.25f;
+
+namespace MinesweeperMemory
+{
+	/** Every Minesweeper session currently open, game thread only */
+	static TArray<const SMinesweeperWidget*> LiveWidgets;
+
+	/** Share of bombs on the boards generated for the report */
+	constexpr int32 ReportBombPercent = 15;
+
+	double GetBytesPerCell(const SIZE_T Bytes, const int64 NumCells)
+	{
+		return NumCells > 0 ? static_cast<double>(Bytes) / NumCells : 0.0;
+	}
+
+	void ReportLiveSessions()
+	{
+		MS_DISPLAY("%d live Minesweeper sessions", LiveWidgets.Num());
+
+		SIZE_T TotalCoreBytes = 0;
+		SIZE_T TotalUIBytes = 0;
+		for (int32 SessionIndex = 0; SessionIndex < LiveWidgets.Num(); ++SessionIndex)
+		{
+			const TSharedPtr<const FMinesweeperCore> GameCore = LiveWidgets[SessionIndex]->GetGameCore();
+			const SIZE_T CoreBytes = GameCore.IsValid() ? GameCore->GetAllocatedSize() : 0;
+			const SIZE_T UIBytes = LiveWidgets[SessionIndex]->GetBoardUIAllocatedSize();
+			const FMinesweeperGameSettings Settings = GameCore.IsValid() ? GameCore->GetGameSettings() : FMinesweeperGameSettings();
+			const int64 NumCells = int64(Settings.GridWidth) * Settings.GridHeight;
+
+			MS_DISPLAY("  Session %d: %dx%d, core %llu bytes (%.2f per cell), UI %llu bytes (%.2f per cell)",
+				SessionIndex, Settings.GridWidth, Settings.GridHeight,
+				uint64(CoreBytes), GetBytesPerCell(CoreBytes, NumCells),
+				uint64(UIBytes), GetBytesPerCell(UIBytes, NumCells));
+
+			TotalCoreBytes += CoreBytes;
+			TotalUIBytes += UIBytes;
+		}
+
+		MS_DISPLAY("  Total: core %llu bytes, UI %llu bytes", uint64(TotalCoreBytes), uint64(TotalUIBytes));
+	}
+
+	void ReportBoardSize(const int32 Size)
+	{
+		FMinesweeperGameSettings Settings(Size, Size, 1, 1);
+		Settings.bLargeBoard = Size > MineSweeperGameGridMax;
+		Settings.ValidateAndClamp();
+		Settings.BombCount = FMath::Max(1, static_cast<int32>(int64(Settings.GridWidth) * Settings.GridHeight * ReportBombPercent / 100));
+		Settings.ValidateAndClamp();
+
+		const int64 NumCells = int64(Settings.GridWidth) * Settings.GridHeight;
+		const SIZE_T PaintedUIBytes = SMinesweeperBoardWidget::GetMaxAllocatedSize(Settings.GridWidth, Settings.GridHeight);
+		const SIZE_T ButtonUIBytes = NumCells * SMinesweeperTileButton::GetEstimatedTileSize();
+
+		for (const EMinesweeperCellLayout Layout : { EMinesweeperCellLayout::RowMajor, EMinesweeperCellLayout::Blocked8x8 })
+		{
+			Settings.CellLayout = Layout;
+			FMinesweeperCore Core;
+			Core.InitializeGame(Settings);
+
+			const SIZE_T CoreBytes = Core.GetAllocatedSize();
+			MS_DISPLAY("  %5dx%-5d %-10s core %12llu bytes (%6.2f per cell)",
+				Settings.GridWidth, Settings.GridHeight, Layout == EMinesweeperCellLayout::RowMajor ? TEXT("RowMajor") : TEXT("Blocked8x8"),
+				uint64(CoreBytes), GetBytesPerCell(CoreBytes, NumCells));
+		}
+
+		MS_DISPLAY("  %5dx%-5d painted UI %12llu bytes (%6.2f per cell)", Settings.GridWidth, Settings.GridHeight, uint64(PaintedUIBytes), GetBytesPerCell(PaintedUIBytes, NumCells));
+		if (NumCells <= MineSweeperMaxTileWidgets)
+		{
+			MS_DISPLAY("  %5dx%-5d button UI  %12llu bytes (%6.2f per cell)", Settings.GridWidth, Settings.GridHeight, uint64(ButtonUIBytes), GetBytesPerCell(ButtonUIBytes, NumCells));
+		}
+	}
+
+	/**
+	 * Logs the memory of the core and of the board view, per cell
+	 * Without arguments every open session is reported. With board sizes, square boards of those sizes are generated in
+	 * each cell layout and reported freshly generated, next to what either board view would hold for them.
+	 */
+	void MemoryReport(const TArray<FString>& Args)
+	{
+		if (Args.IsEmpty())
+		{
+			ReportLiveSessions();
+			return;
+		}
+
+		MS_DISPLAY("Minesweeper memory by board size, %d%% bombs", ReportBombPercent);
+		for (const FString& Arg : Args)
+		{
+			ReportBoardSize(FCString::Atoi(*Arg));
+		}
+	}
+
+	static FAutoConsoleCommand MemoryReportCommand(
+		TEXT("Minesweeper.MemoryReport"),
+		TEXT("Logs core and board view memory per cell. No args: every open session. Args: [Size...] generates square boards of those sizes, e.g. ")
+		TEXT("Minesweeper.MemoryReport 10 50 100 1024 4096"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&MemoryReport));
+}
 
 BEGIN_SLATE_FUNCTION_BUILD_OPTIMIZATION
 
+SMinesweeperWidget::~SMinesweeperWidget()
+{
+	MinesweeperMemory::LiveWidgets.RemoveSingleSwap(this);
+}
+
 void SMinesweeperWidget::Construct(const FArguments& InArgs)
 {
+	LLM_SCOPE_BYTAG(Minesweeper_UI);
+	MinesweeperMemory::LiveWidgets.Add(this);
+
 	// Initialize game logic
 	GameCore = MakeShared<FMinesweeperCore>();
 
@@ -53,13 +188,17 @@ void SMinesweeperWidget::Construct(const FArguments& InArgs)
 				.MinDesiredWidth(1024)
 				.MinDesiredHeight(1024)
 				[
-					CreateGameBoard()
+					// Board widgets only invalidate when the core reports a change, an idle board is served from cache
+					SNew(SInvalidationPanel)
+					[
+						CreateGameBoard()
+					]
 				]
 			]
 		]
 	];
 
-	// Initialize the first game
+	// Initialize the first game, generated in the background
 	InitializeNewGame();
 }
 
@@ -115,7 +254,7 @@ TSharedRef<SWidget> SMinesweeperWidget::CreateGameSettingsPanel()
 					[
 						SAssignNew(WidthSpinBoxUI, SSpinBox<int32>)
 						.MinValue(MineSweeperGameGridMin)
-						.MaxValue(MineSweeperGameGridMax)
+						.MaxValue(PendingGameSettings.GetMaxGridSize())
 						.Value(PendingGameSettings.GridWidth)
 						.OnValueChanged(this, &SMinesweeperWidget::OnWidthUIValueChanged)
 					]
@@ -140,11 +279,26 @@ TSharedRef<SWidget> SMinesweeperWidget::CreateGameSettingsPanel()
 					[
 						SAssignNew(HeightSpinBoxUI, SSpinBox<int32>)
 						.MinValue(MineSweeperGameGridMin)
-						.MaxValue(MineSweeperGameGridMax)
+						.MaxValue(PendingGameSettings.GetMaxGridSize())
 						.Value(PendingGameSettings.GridHeight)
 						.OnValueChanged(this, &SMinesweeperWidget::OnHeightUIValueChanged)
 					]
 				]
+
+				// Large Board Setting
+				+ SHorizontalBox::Slot()
+				.AutoWidth()
+				.Padding(10.0f, 0.0f)
+				[
+					SNew(SCheckBox)
+					.IsChecked(PendingGameSettings.bLargeBoard ? ECheckBoxState::Checked : ECheckBoxState::Unchecked)
+					.OnCheckStateChanged(this, &SMinesweeperWidget::OnLargeBoardUICheckStateChanged)
+					.ToolTipText(NSLOCTEXT("Minesweeper", "LargeBoardTooltip", "Lifts the regular size and mine limits, for stress testing very large boards."))
+					[
+						SNew(STextBlock)
+						.Text(NSLOCTEXT("Minesweeper", "LargeBoardLabel", "Large Board"))
+					]
+				]
 			]
 
 			// Bomb Count Row
@@ -166,10 +320,30 @@ TSharedRef<SWidget> SMinesweeperWidget::CreateGameSettingsPanel()
 				[
 					SAssignNew(BombCountSpinBoxUI, SSpinBox<int32>)
 					.MinValue(MineSweeperBombCountMin)
-					.MaxValue(MineSweeperBombCountMax)
+					.MaxValue(PendingGameSettings.GetMaxBombCount())
 					.Value(PendingGameSettings.BombCount)
 					.OnValueChanged(this, &SMinesweeperWidget::OnBombCountUIValueChanged)
 				]
+
+				// Seed Setting (0 = new random board every game)
+				+ SHorizontalBox::Slot()
+				.AutoWidth()
+				.Padding(20.0f, 5.0f, 0.0f, 5.0f)
+				[
+					SNew(STextBlock)
+					.Text(NSLOCTEXT("Minesweeper", "SeedLabel", "Seed: "))
+					.ToolTipText(NSLOCTEXT("Minesweeper", "SeedTooltip", "Same seed and size always generate the same board. 0 picks a random seed."))
+				]
+				+ SHorizontalBox::Slot()
+				.AutoWidth()
+				.MinWidth(100.0f)
+				[
+					SAssignNew(SeedSpinBoxUI, SSpinBox<int32>)
+					.MinValue(0)
+					.MaxValue(MAX_int32)
+					.Value(PendingGameSettings.RandomSeed)
+					.OnValueChanged(this, &SMinesweeperWidget::OnSeedUIValueChanged)
+				]
 			]
 
 			// Generate New Game Button
@@ -196,6 +370,14 @@ TSharedRef<SWidget> SMinesweeperWidget::CreateGameInfoPanel()
 				.Justification(ETextJustify::Left)
 			]
 
+			// Board Seed Display
+			+ SHorizontalBox::Slot()
+			.HAlign(HAlign_Center)
+			[
+				SAssignNew(BoardSeedTextUI, STextBlock)
+				.Justification(ETextJustify::Center)
+			]
+
 			// Game Status Display
 			+ SHorizontalBox::Slot()
 			.HAlign(HAlign_Right)
@@ -208,61 +390,158 @@ TSharedRef<SWidget> SMinesweeperWidget::CreateGameInfoPanel()
 
 TSharedRef<SWidget> SMinesweeperWidget::CreateGameBoard()
 {
-	return SAssignNew(GameBoardGridPanelUI, SUniformGridPanel);
+	return SAssignNew(GameBoardContainerUI, SBox);
 }
 
-TSharedRef<SWidget> SMinesweeperWidget::CreateTileButton(const int32 X, const int32 Y)
+TSharedRef<SMinesweeperTileButton> SMinesweeperWidget::CreateTileButton(const int32 X, const int32 Y)
 {
-	if (!GameCore.IsValid())
-	{
-		MS_FATAL("GameCore is not valid when creating tile button, please re-check !");
-		return SNew(SButton);
-	}
-
-	TSharedRef<SButton> NewTileButton = SNew(SMinesweeperTileButton)
-		.IsEnabled(this, &SMinesweeperWidget::IsTileButtonInteractable, X, Y)
+	return SNew(SMinesweeperTileButton)
 		.TileX(X)
 		.TileY(Y)
-		.GameCore(GameCore)
 		.OnTileRevealed(this, &SMinesweeperWidget::OnTileRevealed)
 		.OnTileFlagged(this, &SMinesweeperWidget::OnTileFlagged);
-
-	return NewTileButton;
 }
 
 // ==== UI Update Methods
 
+SIZE_T SMinesweeperWidget::GetBoardUIAllocatedSize() const
+{
+	SIZE_T AllocatedSize = PendingTileChanges.GetAllocatedSize() + TileButtonsUI.GetAllocatedSize();
+	if (GameBoardWidgetUI.IsValid())
+	{
+		AllocatedSize += GameBoardWidgetUI->GetAllocatedSize();
+	}
+
+	if (GameBoardGridPanelUI.IsValid())
+	{
+		AllocatedSize += sizeof(SUniformGridPanel) + TileButtonsUI.Num() * SMinesweeperTileButton::GetEstimatedTileSize();
+	}
+
+	return AllocatedSize;
+}
+
 void SMinesweeperWidget::RefreshGameBoardUI()
 {
-	if (!GameBoardGridPanelUI.IsValid() || !GameCore.IsValid())
+	MS_SCOPE_CYCLE_COUNTER(STAT_Minesweeper_RefreshGameBoardUI);
+	LLM_SCOPE_BYTAG(Minesweeper_UI);
+
+	if (!GameBoardContainerUI.IsValid() || !GameCore.IsValid())
+	{
+		MS_ERROR("Invalid GameBoardContainer or GameCore when trying to refresh game board");
+		return;
+	}
+
+	if (CVarMinesweeperBoardView.GetValueOnGameThread() == 1)
 	{
-		MS_ERROR("Invalid GameBoardGridPanel or GameCore when trying to refresh game board");
+		RefreshTileButtonGrid();
 		return;
 	}
 
-	// Clear existing UI
-	GameBoardGridPanelUI->ClearChildren();
+	// The painted board is one widget whatever the board size, it is kept across games
+	GameBoardGridPanelUI.Reset();
+	TileButtonsUI.Empty();
+	if (!GameBoardWidgetUI.IsValid())
+	{
+		SAssignNew(GameBoardWidgetUI, SMinesweeperBoardWidget)
+		.OnTileRevealed(this, &SMinesweeperWidget::OnTileRevealed)
+		.OnTileFlagged(this, &SMinesweeperWidget::OnTileFlagged);
+	}
+
+	GameBoardWidgetUI->SetGameCore(GameCore);
+	GameBoardContainerUI->SetContent(GameBoardWidgetUI.ToSharedRef());
+}
+
+void SMinesweeperWidget::RefreshTileButtonGrid()
+{
+	GameBoardWidgetUI.Reset();
+	if (!GameBoardGridPanelUI.IsValid())
+	{
+		SAssignNew(GameBoardGridPanelUI, SUniformGridPanel);
+		GameBoardContainerUI->SetContent(GameBoardGridPanelUI.ToSharedRef());
+		TileButtonsUI.Reset();
+		TileGridWidth = 0;
+		TileGridHeight = 0;
+	}
 
 	const FMinesweeperGameSettings& Settings = GameCore->GetGameSettings();
 
-	// Create new tile buttons
-	for (int32 Y = 0; Y < Settings.GridHeight; ++Y)
+	// Large boards still play through the core, but would need millions of tile widgets to show
+	if (Settings.GetTotalTiles() > MineSweeperMaxTileWidgets)
 	{
-		for (int32 X = 0; X < Settings.GridWidth; ++X)
+		MS_WARNING("Board of %dx%d tiles is too large to display tile by tile", Settings.GridWidth, Settings.GridHeight);
+		GameBoardGridPanelUI->ClearChildren();
+		TileButtonsUI.Empty();
+		TileGridWidth = 0;
+		TileGridHeight = 0;
+		GameBoardGridPanelUI->AddSlot(0, 0)
+		[
+			SNew(STextBlock)
+			.Text(FText::Format(NSLOCTEXT("Minesweeper", "BoardTooLarge", "{0}x{1} board generated, too large to display tile by tile."), Settings.GridWidth, Settings.GridHeight))
+		];
+		return;
+	}
+
+	// The buttons are pooled, the grid is only laid out again when the board size changes
+	if (Settings.GridWidth != TileGridWidth || Settings.GridHeight != TileGridHeight)
+	{
+		GameBoardGridPanelUI->ClearChildren();
+
+		// Grow or shrink the pool to the new tile count, buttons are indexed like the tiles of the change sets
+		const int32 NumTiles = Settings.GetTotalTiles();
+		const int32 NumPooledButtons = TileButtonsUI.Num();
+		TileButtonsUI.SetNum(NumTiles);
+
+		for (int32 Y = 0; Y < Settings.GridHeight; ++Y)
 		{
-			TSharedRef<SWidget> TileWidget = CreateTileButton(X, Y);
-			GameBoardGridPanelUI->AddSlot(X, Y)
-			[
-				TileWidget
-			];
+			for (int32 X = 0; X < Settings.GridWidth; ++X)
+			{
+				TSharedPtr<SMinesweeperTileButton>& TileButton = TileButtonsUI[Y * Settings.GridWidth + X];
+				if (TileButton.IsValid())
+				{
+					TileButton->SetTileCoordinates(X, Y);
+				}
+				else
+				{
+					TileButton = CreateTileButton(X, Y);
+				}
+
+				GameBoardGridPanelUI->AddSlot(X, Y)
+				[
+					TileButton.ToSharedRef()
+				];
+			}
 		}
+
+		MS_DISPLAY("Laid out a %dx%d tile grid, %d buttons reused", Settings.GridWidth, Settings.GridHeight, FMath::Min(NumPooledButtons, NumTiles));
+		TileGridWidth = Settings.GridWidth;
+		TileGridHeight = Settings.GridHeight;
+	}
+
+	// Rebind every button to the new game, buttons whose tile looks the same are left untouched
+	for (int32 TileIndex = 0; TileIndex < TileButtonsUI.Num(); ++TileIndex)
+	{
+		UpdateTileButton(TileIndex);
 	}
 }
 
+void SMinesweeperWidget::UpdateTileButton(const int32 TileIndex) const
+{
+	MS_SCOPE_CYCLE_COUNTER(STAT_Minesweeper_UpdateTileButton);
+
+	const FMinesweeperBoard& Board = GameCore->GetBoard();
+	const int32 CellIndex = Board.TileToCellIndex(TileIndex);
+	const EMinesweeperTileState TileState = Board.GetTileState(CellIndex);
+
+	// Only unrevealed tiles of a running game take input
+	const bool bInteractable = GameCore->IsGameActive() && !EnumHasAnyFlags(TileState, EMinesweeperTileState::Revealed);
+	TileButtonsUI[TileIndex]->SetTileState(TileState, Board.GetAdjacentBombs(CellIndex), bInteractable);
+}
+
 void SMinesweeperWidget::UpdateGameInfoDisplay() const
 {
 	UpdateFlagCountDisplay();
 	UpdateGameStatusDisplay();
+	UpdateBoardSeedDisplay();
 }
 
 void SMinesweeperWidget::UpdateFlagCountDisplay() const
@@ -284,6 +563,15 @@ void SMinesweeperWidget::UpdateGameStatusDisplay() const
 	}
 }
 
+void SMinesweeperWidget::UpdateBoardSeedDisplay() const
+{
+	if (BoardSeedTextUI.IsValid() && GameCore.IsValid())
+	{
+		// Seed and layout hash identify the exact board, for bug reports and replays
+		BoardSeedTextUI->SetText(FText::FromString(FString::Printf(TEXT("Seed: %d (Board %016llx)"), GameCore->GetGameSettings().RandomSeed, GameCore->GetBoardHash())));
+	}
+}
+
 // ==== UI callbacks
 
 FReply SMinesweeperWidget::OnGenerateNewGameClicked()
@@ -296,7 +584,7 @@ FReply SMinesweeperWidget::OnGenerateNewGameClicked()
 
 void SMinesweeperWidget::OnTileRevealed(const int32 X, const int32 Y)
 {
-	MS_DISPLAY("Try revealing tile [%d - %d]", X, Y);
+	MS_MOVE_DISPLAY("Try revealing tile [%d - %d]", X, Y);
 	if (!GameCore.IsValid())
 		return;
 
@@ -313,7 +601,7 @@ void SMinesweeperWidget::OnTileFlagged(const int32 X, const int32 Y)
 	if (!GameCore.IsValid())
 		return;
 
-	MS_DISPLAY("Toggling flag on tile [%d, %d]", X, Y);
+	MS_MOVE_DISPLAY("Toggling flag on tile [%d, %d]", X, Y);
 
 	GameCore->ToggleFlag(X, Y);
 	UpdateGameInfoDisplay();
@@ -324,18 +612,54 @@ void SMinesweeperWidget::OnWidthUIValueChanged(const int32 NewValue)
 {
 	PendingGameSettings.GridWidth = NewValue;
 	PendingGameSettings.ValidateAndClamp();
+	SchedulePrefetch();
 }
 
 void SMinesweeperWidget::OnHeightUIValueChanged(const int32 NewValue)
 {
 	PendingGameSettings.GridHeight = NewValue;
 	PendingGameSettings.ValidateAndClamp();
+	SchedulePrefetch();
 }
 
 void SMinesweeperWidget::OnBombCountUIValueChanged(const int32 NewValue)
 {
 	PendingGameSettings.BombCount = NewValue;
 	PendingGameSettings.ValidateAndClamp();
+	SchedulePrefetch();
+}
+
+void SMinesweeperWidget::OnSeedUIValueChanged(const int32 NewValue)
+{
+	PendingGameSettings.RandomSeed = NewValue;
+	SchedulePrefetch();
+}
+
+void SMinesweeperWidget::OnLargeBoardUICheckStateChanged(const ECheckBoxState NewState)
+{
+	PendingGameSettings.bLargeBoard = NewState == ECheckBoxState::Checked;
+
+	// Huge boards are stored in 8x8 blocks so flood fills stay within a few cache lines
+	PendingGameSettings.CellLayout = PendingGameSettings.bLargeBoard ? EMinesweeperCellLayout::Blocked8x8 : EMinesweeperCellLayout::RowMajor;
+	PendingGameSettings.ValidateAndClamp();
+
+	// Widen or narrow the spin box ranges to the limits of the selected mode
+	const int32 MaxGridSize = PendingGameSettings.GetMaxGridSize();
+	const int32 MaxBombCount = PendingGameSettings.GetMaxBombCount();
+
+	WidthSpinBoxUI->SetMaxValue(MaxGridSize);
+	WidthSpinBoxUI->SetMaxSliderValue(MaxGridSize);
+	WidthSpinBoxUI->SetValue(PendingGameSettings.GridWidth);
+
+	HeightSpinBoxUI->SetMaxValue(MaxGridSize);
+	HeightSpinBoxUI->SetMaxSliderValue(MaxGridSize);
+	HeightSpinBoxUI->SetValue(PendingGameSettings.GridHeight);
+
+	BombCountSpinBoxUI->SetMaxValue(MaxBombCount);
+	BombCountSpinBoxUI->SetMaxSliderValue(MaxBombCount);
+	BombCountSpinBoxUI->SetValue(PendingGameSettings.BombCount);
+
+	PrefetchNextGame();
 }
 
 // ==== UI Attribute Getters (for dynamic UI updates)
@@ -374,34 +698,212 @@ FText SMinesweeperWidget::GetFlagCountText(const int32 FlaggedCount, const int32
 	return FText::FromString(FlagText);
 }
 
-bool SMinesweeperWidget::IsTileButtonInteractable(const int32 X, const int32 Y) const
-{
-	if (!GameCore.IsValid() || !GameCore->IsGameActive())
-		return false;
-
-	const FMinesweeperTile* Tile = GameCore->GetTile(X, Y);
-	if (!Tile)
-		return false;
-
-	// Only allow interaction with unrevealed tiles
-	return !Tile->bIsRevealed;
-}
-
 // ==== Game flow
 
 void SMinesweeperWidget::InitializeNewGame()
 {
-	if (!GameCore.IsValid())
+	// Usually the board for these settings was prefetched while the last game was played
+	const TSharedPtr<FMinesweeperCore> ReadyGameCore = GameGenerator.TakeReadyGame(PendingGameSettings);
+	if (ReadyGameCore.IsValid())
 	{
-		MS_ERROR("GameCore is invalid when trying to initialize new game");
+		StartGame(ReadyGameCore);
 		return;
 	}
 
-	GameCore->InitializeGame(PendingGameSettings);
+	// Otherwise build it, even where prefetching is skipped, and wait for it without blocking the editor, polling once per frame
+	GameGenerator.Prefetch(PendingGameSettings);
+	if (!GenerationTimerHandle.IsValid())
+	{
+		GenerationTimerHandle = RegisterActiveTimer(0.0f, FWidgetActiveTimerDelegate::CreateSP(this, &SMinesweeperWidget::WaitForGeneratedGame));
+	}
+}
+
+void SMinesweeperWidget::StartGame(const TSharedPtr<FMinesweeperCore>& NewGameCore)
+{
+	// Board widgets only hold weak references to the core, the old one goes away with them
+	if (GameCore.IsValid())
+	{
+		GameCore->OnChangeSet().Remove(ChangeSetHandle);
+	}
+
+	// Whatever the old game still had queued for the view is moot, the view is rebuilt from the new core
+	CancelPendingViewUpdates();
+
+	GameCore = NewGameCore;
+	ChangeSetHandle = GameCore->OnChangeSet().AddSP(this, &SMinesweeperWidget::OnGameCoreChangeSet);
 
 	// Refresh the UI
 	RefreshGameBoardUI();
 	UpdateGameInfoDisplay();
+
+	// Start on the game after this one
+	PrefetchNextGame();
+}
+
+EActiveTimerReturnType SMinesweeperWidget::WaitForGeneratedGame(const double InCurrentTime, const float InDeltaTime)
+{
+	const TSharedPtr<FMinesweeperCore> ReadyGameCore = GameGenerator.TakeReadyGame(PendingGameSettings);
+	if (ReadyGameCore.IsValid())
+	{
+		GenerationTimerHandle.Reset();
+		StartGame(ReadyGameCore);
+		return EActiveTimerReturnType::Stop;
+	}
+
+	// Settings may have changed while waiting, the new game is built for whatever is pending now
+	GameGenerator.Prefetch(PendingGameSettings);
+
+	if (GameStatusTextUI.IsValid())
+	{
+		GameStatusTextUI->SetText(FText::FromString(FString::Printf(TEXT("Generating board... %d%%"), FMath::RoundToInt(GameGenerator.GetProgress() * 100.0f))));
+	}
+
+	return EActiveTimerReturnType::Continue;
+}
+
+void SMinesweeperWidget::PrefetchNextGame()
+{
+	// A large board can take seconds and gigabytes to build, too much to spend on a game that may never be played.
+	// Those are only built once New Game asks for them.
+	if (PendingGameSettings.bLargeBoard)
+		return;
+
+	// No-op when a game for these settings is already built or being built
+	GameGenerator.Prefetch(PendingGameSettings);
+}
+
+void SMinesweeperWidget::SchedulePrefetch()
+{
+	// A waiting timer picks up the latest settings, it only needs to wait a little longer
+	if (PrefetchTimerHandle.IsValid())
+	{
+		bPendingSettingsChanged = true;
+		return;
+	}
+
+	PrefetchTimerHandle = RegisterActiveTimer(MineSweeperPrefetchIdleSeconds, FWidgetActiveTimerDelegate::CreateSP(this, &SMinesweeperWidget::PrefetchWhenIdle));
+}
+
+EActiveTimerReturnType SMinesweeperWidget::PrefetchWhenIdle(const double InCurrentTime, const float InDeltaTime)
+{
+	// Still being edited, check again after another idle period
+	if (bPendingSettingsChanged)
+	{
+		bPendingSettingsChanged = false;
+		return EActiveTimerReturnType::Continue;
+	}
+
+	PrefetchTimerHandle.Reset();
+	PrefetchNextGame();
+	return EActiveTimerReturnType::Stop;
+}
+
+void SMinesweeperWidget::OnGameCoreChangeSet(const FMinesweeperChangeSet& ChangeSet)
+{
+	LLM_SCOPE_BYTAG(Minesweeper_UI);
+
+	// The core broadcasts once it is done with the move, whatever follows is view work
+	FMinesweeperLatencyProbe::MarkCoreFinished(GameCore->GetGameSettings().GridWidth, GameCore->GetGameSettings().GridHeight);
+
+	// Every tile stops taking input when the game ends, the tile count is bounded by MineSweeperMaxTileWidgets
+	if (ChangeSet.HasGameStateChanged())
+	{
+		for (int32 TileIndex = 0; TileIndex < TileButtonsUI.Num(); ++TileIndex)
+		{
+			UpdateTileButton(TileIndex);
+		}
+	}
+
+	// The painted board reads its tiles straight from the core, only its level of detail has to catch up
+	if (GameBoardWidgetUI.IsValid())
+	{
+		GameBoardWidgetUI->ApplyChangeSet(ChangeSet);
+	}
+
+	// Button boards are at most MineSweeperMaxTileWidgets tiles, so openings are expanded into per-tile changes,
+	// kept in order behind any that are still queued
+	if (!TileButtonsUI.IsEmpty())
+	{
+		const bool bWasQueueEmpty = PendingTileChanges.IsEmpty();
+		PendingTileChanges.Append(ChangeSet.TileChanges);
+
+		const FMinesweeperBoard& Board = GameCore->GetBoard();
+		for (const FMinesweeperRevealedCells& RevealedCells : ChangeSet.RevealedCells)
+		{
+			Board.ForEachCellOfWord(RevealedCells.WordIndex, RevealedCells.CellMask, [this, &Board](const int32 CellIndex, const int32 X, const int32 Y) {
+				PendingTileChanges.Emplace(Board.GetTileIndex(X, Y), EMinesweeperTileState::None, EMinesweeperTileState::Revealed);
+			});
+		}
+
+		if (bWasQueueEmpty && PendingTileChanges.Num() <= MineSweeperImmediateTileChanges)
+		{
+			ApplyTileChangesToView(PendingTileChanges);
+			PendingTileChanges.Reset();
+		}
+	}
+
+	const bool bLodStale = GameBoardWidgetUI.IsValid() && GameBoardWidgetUI->HasStaleLevelOfDetail();
+	if (PendingTileChanges.IsEmpty() && !bLodStale)
+	{
+		FMinesweeperLatencyProbe::MarkViewUpdated();
+		return;
+	}
+
+	if (!ViewUpdateTimerHandle.IsValid())
+	{
+		MS_DISPLAY("Updating the board view over several frames, %d tile changes queued", PendingTileChanges.Num() - NextPendingTileChange);
+		ViewUpdateTimerHandle = RegisterActiveTimer(0.0f, FWidgetActiveTimerDelegate::CreateSP(this, &SMinesweeperWidget::ApplyPendingViewUpdates));
+	}
+}
+
+void SMinesweeperWidget::ApplyTileChangesToView(const TConstArrayView<FMinesweeperTileChange> TileChanges)
+{
+	MS_SCOPE_CYCLE_COUNTER(STAT_Minesweeper_ApplyTileChangesToView);
+
+	for (const FMinesweeperTileChange& TileChange : TileChanges)
+	{
+		if (TileButtonsUI.IsValidIndex(TileChange.TileIndex))
+		{
+			UpdateTileButton(TileChange.TileIndex);
+		}
+	}
+}
+
+EActiveTimerReturnType SMinesweeperWidget::ApplyPendingViewUpdates(const double InCurrentTime, const float InDeltaTime)
+{
+	const double EndTime = FPlatformTime::Seconds() + CVarMinesweeperViewUpdateBudgetMs.GetValueOnGameThread() / 1000.0;
+
+	// Only one of the two views exists, each makes some progress even with a budget of 0
+	const bool bLodUpToDate = !GameBoardWidgetUI.IsValid() || GameBoardWidgetUI->RefreshLevelOfDetail(EndTime);
+
+	while (NextPendingTileChange < PendingTileChanges.Num())
+	{
+		const int32 NumChanges = FMath::Min(MineSweeperTileChangesPerBudgetCheck, PendingTileChanges.Num() - NextPendingTileChange);
+		ApplyTileChangesToView(TConstArrayView<FMinesweeperTileChange>(PendingTileChanges).Slice(NextPendingTileChange, NumChanges));
+		NextPendingTileChange += NumChanges;
+
+		if (FPlatformTime::Seconds() >= EndTime)
+			break;
+	}
+
+	if (!bLodUpToDate || NextPendingTileChange < PendingTileChanges.Num())
+		return EActiveTimerReturnType::Continue;
+
+	CancelPendingViewUpdates();
+	FMinesweeperLatencyProbe::MarkViewUpdated();
+	return EActiveTimerReturnType::Stop;
+}
+
+void SMinesweeperWidget::CancelPendingViewUpdates()
+{
+	if (ViewUpdateTimerHandle.IsValid())
+	{
+		UnRegisterActiveTimer(ViewUpdateTimerHandle.ToSharedRef());
+		ViewUpdateTimerHandle.Reset();
+	}
+
+	PendingTileChanges.Empty();
+	NextPendingTileChange = 0;
 }
 
 void SMinesweeperWidget::HandleGameStateChange(const EMinesweeperGameState NewState)
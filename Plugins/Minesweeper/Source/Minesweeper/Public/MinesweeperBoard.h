@@ -0,0 +1,295 @@
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MinesweeperTypes.h"
+
+/**
+ * Packed storage for a Minesweeper board
+ * Bomb, revealed and flagged states are kept in 64-bit bitplanes (one bit per cell), adjacent bomb
+ * counts are packed two cells per byte. Whole-board operations work a word at a time.
+ *
+ * The grid is stored with a one-cell border ring around the playable tiles. Border cells never hold
+ * bombs or flags and are permanently marked revealed, so neighbour walks need no bounds checks.
+ * Cells are laid out either in padded rows or in 8x8 blocks (see EMinesweeperCellLayout); in both
+ * layouts every 64-bit word of a plane covers 64 cells.
+ *
+ * Two index spaces are used:
+ *  - Tile index, the public row-major index (Y * Width + X)
+ *  - Cell index, the internal layout-dependent index used by all per-cell accessors
+ */
+class MINESWEEPER_API FMinesweeperBoard
+{
+public:
+	/** Number of neighbours of a cell */
+	static constexpr int32 NumNeighbors = 8;
+
+	/** Neighbour directions, in the order ForEachNeighbor() visits them */
+	static constexpr int32 NeighborDeltaX[NumNeighbors] = { -1, 0, 1, -1, 1, -1, 0, 1 };
+	static constexpr int32 NeighborDeltaY[NumNeighbors] = { -1, -1, -1, 0, 0, 1, 1, 1 };
+
+	/** Allocates a cleared board of the given size */
+	void Initialize(const int32 InWidth, const int32 InHeight, const EMinesweeperCellLayout InLayout = EMinesweeperCellLayout::RowMajor);
+
+	/** Releases all storage */
+	void Empty();
+
+	// Dimensions
+	int32 GetWidth() const { return Width; }
+	int32 GetHeight() const { return Height; }
+	int32 GetNumTiles() const { return Width * Height; }
+	int32 GetTileIndex(const int32 X, const int32 Y) const { return Y * Width + X; }
+	EMinesweeperCellLayout GetLayout() const { return Layout; }
+
+	// Index translation
+	int32 GetCellIndex(const int32 X, const int32 Y) const
+	{
+		return Layout == EMinesweeperCellLayout::RowMajor ? (Y + 1) * Stride + X + 1 : GetBlockedCellIndex(X + 1, Y + 1);
+	}
+
+	int32 TileToCellIndex(const int32 TileIndex) const { return GetCellIndex(TileIndex % Width, TileIndex / Width); }
+	int32 CellToTileIndex(const int32 CellIndex) const;
+	void GetCellCoordinates(const int32 CellIndex, int32& OutX, int32& OutY) const;
+
+	// Iteration
+	/** Calls Func(NeighborCellIndex) for each of the 8 neighbours of a playable cell, border cells included */
+	template <typename FuncType>
+	void ForEachNeighbor(const int32 CellIndex, FuncType&& Func) const;
+
+	/** Calls Func(CellIndex, X, Y) for every playable tile, in memory order so consecutive calls share cache lines */
+	template <typename FuncType>
+	void ForEachTile(FuncType&& Func) const;
+
+	/** Calls Func(CellIndex, X, Y) for each cell set in a plane word mask. Lanes run in row order in both layouts, so the first and last calls hold the lowest and highest Y. */
+	template <typename FuncType>
+	void ForEachCellOfWord(const int32 WordIndex, uint64 CellMask, FuncType&& Func) const;
+
+	// Per-cell access, Index is the cell index
+	bool IsBomb(const int32 Index) const { return TestBit(BombPlane, Index); }
+	bool IsRevealed(const int32 Index) const { return TestBit(RevealedPlane, Index); }
+	bool IsFlagged(const int32 Index) const { return TestBit(FlaggedPlane, Index); }
+	int32 GetAdjacentBombs(const int32 Index) const { return (AdjacentCounts[Index >> 1] >> ((Index & 1) << 2)) & 0xF; }
+
+	void SetBomb(const int32 Index, const bool bValue) { WriteBit(BombPlane, Index, bValue); }
+	void SetRevealed(const int32 Index, const bool bValue) { WriteBit(RevealedPlane, Index, bValue); }
+	void SetFlagged(const int32 Index, const bool bValue) { WriteBit(FlaggedPlane, Index, bValue); }
+	void SetAdjacentBombs(const int32 Index, const int32 Count);
+
+	/** Unpacks a single cell */
+	FMinesweeperTile GetTile(const int32 Index) const;
+
+	/** State bits of a single cell, in the form change sets use */
+	EMinesweeperTileState GetTileState(const int32 Index) const
+	{
+		return (IsBomb(Index) ? EMinesweeperTileState::Bomb : EMinesweeperTileState::None)
+			| (IsRevealed(Index) ? EMinesweeperTileState::Revealed : EMinesweeperTileState::None)
+			| (IsFlagged(Index) ? EMinesweeperTileState::Flagged : EMinesweeperTileState::None);
+	}
+
+	// Whole-board operations
+	/**
+	 * Reveals every bomb and flagged tile, optionally flagging all bombs as well
+	 * @param OutChanges Optional, receives every tile this changed
+	 */
+	void RevealBombsAndFlags(const bool bFlagBombs, TArray<FMinesweeperTileChange>* OutChanges = nullptr);
+	int32 CountCorrectFlags() const;
+	int32 CountIncorrectFlags() const;
+
+	/**
+	 * Fills in the adjacent bomb count of every non-bomb tile from the bomb plane
+	 * Works on 64 cells at a time: the 8 neighbour masks are shifted copies of the surrounding bomb
+	 * words (rows above and below, or neighbouring blocks), summed with a bit-sliced adder.
+	 * @param bParallel Split the board into row bands processed with ParallelFor, the result is identical
+	 * @param OnProgress Polled before each band with the share of the pass done, may be called from any thread. Returning false abandons the pass.
+	 * @return False when OnProgress abandoned the pass, the counts are incomplete then
+	 */
+	bool ComputeAdjacentCounts(const bool bParallel = false, const TFunctionRef<bool(const float)> OnProgress = [](const float) { return true; });
+
+	/** Checks the packed counts against a plain per-tile 3x3 scan, for validation only */
+	bool VerifyAdjacentCounts() const;
+
+	// Zero regions
+	/**
+	 * Labels the openings of the board, for bulk reveals
+	 * Zero tiles are grouped into 8-connected regions with union-find. The opening of a region is its
+	 * zero tiles plus the numbered tiles around them, stored as (plane word, cell mask) pairs so
+	 * revealing it is one OR per word. Must run after ComputeAdjacentCounts().
+	 * @param bParallel Run the union-find in row bands with ParallelFor, labels are identical either way
+	 * @param OnProgress Polled before each band and between the sweeps with the share of the pass done, may be called from any thread. Returning false abandons the pass.
+	 * @return False when OnProgress abandoned the pass, the board has no zero regions then
+	 */
+	bool ComputeZeroRegions(const bool bParallel = false, const TFunctionRef<bool(const float)> OnProgress = [](const float) { return true; });
+
+	int32 GetNumZeroRegions() const { return FMath::Max(ZeroRegionStarts.Num() - 1, 0); }
+
+	/** Region of a zero tile, INDEX_NONE for other cells or when regions have not been computed */
+	int32 GetZeroRegion(const int32 Index) const { return ZeroRegionLabels.Num() > 0 ? ZeroRegionLabels[Index] : INDEX_NONE; }
+
+	/**
+	 * Collects the distinct regions whose opening contains a cell: its own region and those of its zero neighbours
+	 * @return Number of regions written to OutRegions
+	 */
+	int32 GetZeroRegionsContaining(const int32 Index, int32 (&OutRegions)[NumNeighbors + 1]) const;
+
+	/**
+	 * Marks the whole opening of a region revealed
+	 * @param OutRevealedCells Optional, receives the newly revealed cells one plane word at a time
+	 * @return Number of newly revealed tiles
+	 */
+	int32 RevealZeroRegion(const int32 Region, TArray<FMinesweeperRevealedCells>* OutRevealedCells);
+
+	/**
+	 * Hash of the board size and bomb layout
+	 * Only depends on which tiles hold bombs, not on how the planes are stored, so it can be compared across machines.
+	 */
+	uint64 ComputeLayoutHash() const;
+
+	/** Heap memory held by the planes, counts and zero regions, excluding the board object itself */
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	int32 GetBlockedCellIndex(const int32 PaddedX, const int32 PaddedY) const
+	{
+		return (((PaddedY >> 3) * BlocksPerRow + (PaddedX >> 3)) << 6) | ((PaddedY & 7) << 3) | (PaddedX & 7);
+	}
+
+	/** Rows of the storage grid: padded rows for row-major boards, rows of 8x8 blocks for blocked ones */
+	int32 GetNumStorageRows() const { return Layout == EMinesweeperCellLayout::RowMajor ? Height + 2 : BlockRows; }
+	int32 GetCellsPerStorageRow() const { return Layout == EMinesweeperCellLayout::RowMajor ? Stride : BlocksPerRow * 64; }
+
+	/** Like ForEachTile(), limited to storage rows [FirstRow, EndRow), which is a contiguous range of cell indices */
+	template <typename FuncType>
+	void ForEachTileInStorageRows(const int32 FirstRow, const int32 EndRow, FuncType&& Func) const;
+
+	/** Playable cells of a plane word */
+	uint64 GetPlayableMask(const int32 WordIndex) const;
+
+	/** Adjacency kernels, each fills in the counts of storage rows [FirstRow, EndRow) */
+	void ComputeAdjacentCountsRowMajor(const int32 FirstRow, const int32 EndRow);
+	void ComputeAdjacentCountsBlocked(const int32 FirstRow, const int32 EndRow);
+
+	/** Stores the 4-bit counts of the non-zero lanes of one plane word */
+	void StoreAdjacentCounts(const int32 WordIndex, const uint64 Bit0, const uint64 Bit1, const uint64 Bit2, const uint64 Bit3);
+
+	/** Copies the bomb bits of row Y into OutWords, one bit per column, unused high bits cleared */
+	void ExtractBombRow(const int32 Y, uint64* OutWords) const;
+
+	static bool TestBit(const TArray<uint64>& Plane, const int32 Index)
+	{
+		return (Plane[Index >> 6] >> (Index & 63)) & 1;
+	}
+
+	static void WriteBit(TArray<uint64>& Plane, const int32 Index, const bool bValue)
+	{
+		const uint64 Mask = uint64(1) << (Index & 63);
+		Plane[Index >> 6] = bValue ? (Plane[Index >> 6] | Mask) : (Plane[Index >> 6] & ~Mask);
+	}
+
+private:
+	int32 Width = 0;
+	int32 Height = 0;
+	EMinesweeperCellLayout Layout = EMinesweeperCellLayout::RowMajor;
+
+	/** Row-major layout: cells per padded row (a multiple of 64) and words per row */
+	int32 Stride = 0;
+	int32 RowWords = 0;
+
+	/** Blocked layout: 8x8 blocks per row of blocks, and rows of blocks */
+	int32 BlocksPerRow = 0;
+	int32 BlockRows = 0;
+
+	/** Row-major layout: cell index offsets of the 8 neighbours, the same for every playable cell */
+	int32 NeighborOffsets[NumNeighbors] = {};
+
+	/** Blocked layout: neighbour offsets for each lane of a block, edge lanes reach into the adjacent blocks */
+	int32 BlockNeighborOffsets[64][NumNeighbors] = {};
+
+	/** Row-major layout: playable columns of a padded row, one mask per row word */
+	TArray<uint64> PlayableRowMask;
+
+	/** One bit per cell, border cells are always zero except in the revealed plane */
+	TArray<uint64> BombPlane;
+	TArray<uint64> RevealedPlane;
+	TArray<uint64> FlaggedPlane;
+
+	/** 4 bits per cell, even cells in the low nibble */
+	TArray<uint8> AdjacentCounts;
+
+	/** Zero region of every cell, INDEX_NONE for non-zero cells. Empty when regions were not computed. */
+	TArray<int32> ZeroRegionLabels;
+
+	/** Openings of the zero regions, region R owns pairs [ZeroRegionStarts[R], ZeroRegionStarts[R + 1]) */
+	TArray<int32> ZeroRegionStarts;
+	TArray<int32> ZeroRegionWords;
+	TArray<uint64> ZeroRegionMasks;
+};
+
+template <typename FuncType>
+void FMinesweeperBoard::ForEachNeighbor(const int32 CellIndex, FuncType&& Func) const
+{
+	// Row-major offsets are the same for every cell, blocked offsets only depend on the lane inside the block
+	const int32* Offsets = Layout == EMinesweeperCellLayout::RowMajor ? NeighborOffsets : BlockNeighborOffsets[CellIndex & 63];
+
+	for (int32 Direction = 0; Direction < NumNeighbors; ++Direction)
+	{
+		Func(CellIndex + Offsets[Direction]);
+	}
+}
+
+template <typename FuncType>
+void FMinesweeperBoard::ForEachTile(FuncType&& Func) const
+{
+	ForEachTileInStorageRows(0, GetNumStorageRows(), Forward<FuncType>(Func));
+}
+
+template <typename FuncType>
+void FMinesweeperBoard::ForEachCellOfWord(const int32 WordIndex, uint64 CellMask, FuncType&& Func) const
+{
+	while (CellMask != 0)
+	{
+		const int32 CellIndex = WordIndex * 64 + static_cast<int32>(FMath::CountTrailingZeros64(CellMask));
+		int32 X, Y;
+		GetCellCoordinates(CellIndex, X, Y);
+		Func(CellIndex, X, Y);
+		CellMask &= CellMask - 1;
+	}
+}
+
+template <typename FuncType>
+void FMinesweeperBoard::ForEachTileInStorageRows(const int32 FirstRow, const int32 EndRow, FuncType&& Func) const
+{
+	if (Layout == EMinesweeperCellLayout::RowMajor)
+	{
+		// Padded rows, only 1..Height hold tiles
+		for (int32 PaddedY = FMath::Max(FirstRow, 1); PaddedY < FMath::Min(EndRow, Height + 1); ++PaddedY)
+		{
+			for (int32 X = 0; X < Width; ++X)
+			{
+				Func(GetCellIndex(X, PaddedY - 1), X, PaddedY - 1);
+			}
+		}
+		return;
+	}
+
+	// Block by block, then row by row inside each block
+	for (int32 BlockY = FirstRow; BlockY < EndRow; ++BlockY)
+	{
+		const int32 MinY = FMath::Max(BlockY * 8, 1);
+		const int32 MaxY = FMath::Min(BlockY * 8 + 7, Height);
+
+		for (int32 BlockX = 0; BlockX < BlocksPerRow; ++BlockX)
+		{
+			const int32 MinX = FMath::Max(BlockX * 8, 1);
+			const int32 MaxX = FMath::Min(BlockX * 8 + 7, Width);
+
+			for (int32 PaddedY = MinY; PaddedY <= MaxY; ++PaddedY)
+			{
+				for (int32 PaddedX = MinX; PaddedX <= MaxX; ++PaddedX)
+				{
+					Func(GetBlockedCellIndex(PaddedX, PaddedY), PaddedX - 1, PaddedY - 1);
+				}
+			}
+		}
+	}
+}
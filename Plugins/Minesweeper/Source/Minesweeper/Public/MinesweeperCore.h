@@ -3,8 +3,15 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "MinesweeperBoard.h"
 #include "MinesweeperTypes.h"
 
+/** Reports generation progress in [0, 1], may be called from any thread. Returning false abandons the generation. */
+DECLARE_DELEGATE_RetVal_OneParam(bool, FOnMinesweeperGenerationProgress, const float /*Progress*/);
+
+/** Published after every operation that changed the board or the game state */
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnMinesweeperChangeSet, const FMinesweeperChangeSet& /*ChangeSet*/);
+
 /**
  * Core game logic for Minesweeper
  * Handles all game state management and rules
@@ -16,12 +23,40 @@ public:
 	~FMinesweeperCore();
 
 	// Game Management
-	void InitializeGame(const FMinesweeperGameSettings& InSettings);
+	/**
+	 * Generates a new board and starts the game, safe to run off the game thread on a core nothing else is using
+	 * @param OnProgress Optional, polled between generation steps. If it returns false the core is left reset and not started.
+	 */
+	void InitializeGame(const FMinesweeperGameSettings& InSettings, const FOnMinesweeperGenerationProgress& OnProgress = FOnMinesweeperGenerationProgress());
 	void ResetGame();
 
+	/** Rolls a seed for games that did not ask for one, never 0 since 0 means no seed */
+	static int32 MakeRandomSeed();
+
 	// Tile Operations
-	bool RevealTile(const int32 X, const int32 Y);
-	void ToggleFlag(const int32 X, const int32 Y);
+	/**
+	 * Reveals the tile at the given coordinate, opening the surrounding region when it has no adjacent bombs.
+	 * @param OutChangeSet Optional, receives every tile this call changed and the game state transition
+	 */
+	bool RevealTile(const int32 X, const int32 Y, FMinesweeperChangeSet* OutChangeSet = nullptr);
+
+	/**
+	 * Flags or unflags the tile at the given coordinate
+	 * @param OutChangeSet Optional, receives every tile this call changed and the game state transition
+	 */
+	void ToggleFlag(const int32 X, const int32 Y, FMinesweeperChangeSet* OutChangeSet = nullptr);
+
+	/**
+	 * Applies a batch of moves in order, with one validation pass, one game end evaluation and one merged change set
+	 * Off-board moves and moves that do not apply (revealing a flag, chording an unsatisfied number...) are skipped.
+	 * The batch stops at the move that wins or loses the game.
+	 * @param OutChangeSet Optional, receives every tile the batch changed and the game state transition
+	 * @return Number of moves that changed the board
+	 */
+	int32 ApplyMoves(const TConstArrayView<FMinesweeperMove> Moves, FMinesweeperChangeSet* OutChangeSet = nullptr);
+
+	/** Broadcast with the change set of every operation that changed something, for consumers that follow the game rather than drive it */
+	FOnMinesweeperChangeSet& OnChangeSet() { return ChangeSetDelegate; }
 
 	// Game State Queries
 	EMinesweeperGameState GetGameState() const { return CurrentGameState; }
@@ -29,22 +64,64 @@ public:
 	bool IsGameActive() const { return CurrentGameState == EMinesweeperGameState::Active; }
 	bool IsGameWon() const { return CurrentGameState == EMinesweeperGameState::Won; }
 
+	/** Hash of the current bomb layout, identical boards give identical hashes on every machine */
+	uint64 GetBoardHash() const { return BoardHash; }
+
 	// Tile Queries
-	const FMinesweeperTile* GetTile(const int32 X, const int32 Y) const;
+	FMinesweeperTileProxy GetTile(const int32 X, const int32 Y) const;
+	const FMinesweeperBoard& GetBoard() const { return Board; }
 	bool IsValidCoordinate(const int32 X, const int32 Y) const;
 	int32 GetRevealedTileCount() const { return RevealedTileCount; }
 	int32 GetFlaggedTileCount() const { return FlaggedTileCount; }
 	int32 GetRemainingFlags() const { return GameSettings.BombCount - FlaggedTileCount; }
 	int32 GetTileIndex(const int32 X, const int32 Y) const;
 
+	/** Memory held by this core, the object itself plus the board and all scratch storage */
+	SIZE_T GetAllocatedSize() const;
+
 private:
+	/** Times the generation steps and the win check on their own */
+	friend struct FMinesweeperCoreBenchmark;
+
+	/** Steers reveals to the zero region or the flood path to compare them */
+	friend struct FMinesweeperCoreTest;
+
 	// Internal Logic
 	void EndGame(const bool bWon);
 	void CheckWinCondition();
-	void GenerateBoardTiles();
-	void PlaceBombsRandomly();
-	void CalculateAdjacentBombs();
-	void RevealAdjacentTiles(const int32 X, const int32 Y);
+	bool IsWinConditionMet() const;
+	bool GenerateBoardTiles(const FOnMinesweeperGenerationProgress& OnProgress);
+	bool PlaceBombsRandomly(const FOnMinesweeperGenerationProgress& OnProgress);
+	bool CalculateAdjacentBombs(const bool bParallel, const FOnMinesweeperGenerationProgress& OnProgress);
+
+	// Cell-level moves, no validation, logging or game end evaluation
+	/** Reveals a hidden, unflagged cell and opens its region if it is a zero tile. Returns false when it was a bomb, which ends the game. */
+	bool RevealCell(const int32 CellIndex);
+
+	/** Sets or clears the flag of a hidden cell, returns false when nothing changed */
+	bool SetCellFlagged(const int32 CellIndex, const bool bFlagged);
+
+	/** Reveals the hidden neighbours of a revealed number once its flags match its count, returns false when nothing was revealed */
+	bool ChordCell(const int32 CellIndex);
+
+	void FloodRevealFrom(const int32 StartCellIndex);
+	bool TryRevealZeroRegion(const int32 CellIndex);
+
+	// Change sets
+	/** Starts recording an operation into OutChangeSet, or into scratch storage when only the delegate listens */
+	void BeginChangeSet(FMinesweeperChangeSet* OutChangeSet);
+
+	/** Closes the recording, broadcasting it when it holds any change */
+	void FinishChangeSet();
+
+	/** Where the running operation records tile changes, null when nobody asked for them */
+	TArray<FMinesweeperTileChange>* GetRecordedTileChanges() const { return ActiveChangeSet ? &ActiveChangeSet->TileChanges : nullptr; }
+	TArray<FMinesweeperRevealedCells>* GetRecordedRevealedCells() const { return ActiveChangeSet ? &ActiveChangeSet->RevealedCells : nullptr; }
+	void RecordTileChange(const int32 CellIndex, const EMinesweeperTileState OldState);
+
+	/** Records a safe tile revealed by a flood, merged into the change set's revealed cell masks */
+	void RecordRevealedCell(const int32 CellIndex);
+	void UpdateZeroRegionFlagCounts(const int32 CellIndex, const int32 Delta);
 
 private:
 	/** Current game state */
@@ -53,10 +130,48 @@ private:
 	/** Game configuration settings */
 	FMinesweeperGameSettings GameSettings;
 
-	/** Array of all tiles on the board */
-	TArray<FMinesweeperTile> GameBoardTiles;
+	/** Packed tile storage */
+	FMinesweeperBoard Board;
+
+	/** Layout hash of the generated board */
+	uint64 BoardHash;
 
 	/** Statistics */
 	int32 RevealedTileCount;
 	int32 FlaggedTileCount;
+
+	/** Running win condition counters, kept up to date by RevealTile/ToggleFlag */
+	int32 SafeRevealedTileCount;
+	int32 CorrectFlagCount;
+	int32 IncorrectFlagCount;
+
+	/** Flood reveal scratch (board cell indices), kept around so repeated clicks don't reallocate */
+	TArray<int32> FloodWorklist;
+
+	/** ApplyMoves scratch, cell index of each move or INDEX_NONE when it is off the board */
+	TArray<int32> BatchCellIndices;
+
+	/** Consumed worklist entries tolerated before the flood compacts the worklist */
+	static constexpr int32 FloodWorklistCompactThreshold = 4096;
+
+	/** Revealed cell entries recorded before repeated words are merged, doubles after each merge */
+	static constexpr int32 RevealedCellsCompactThreshold = 4096;
+	int32 RevealedCellsCompactAt = RevealedCellsCompactThreshold;
+
+	/** Flags currently inside the opening of each zero region, an opening holding flags can't be bulk revealed */
+	TArray<int32> ZeroRegionFlagCounts;
+
+	/** Zero regions already opened by a flood, their remaining tiles depend on where the flood stopped */
+	TBitArray<> OpenedZeroRegions;
+
+	/** Largest board that gets precomputed zero regions, the labels cost 4 bytes per cell */
+	static constexpr int32 ZeroRegionMaxTiles = 4096 * 4096;
+
+	/** Change set of the operation in progress, null outside operations or when nothing records */
+	FMinesweeperChangeSet* ActiveChangeSet = nullptr;
+
+	/** Recording target when the caller passed no change set but the delegate is bound */
+	FMinesweeperChangeSet DelegateChangeSet;
+
+	FOnMinesweeperChangeSet ChangeSetDelegate;
 };
@@ -0,0 +1,35 @@
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MinesweeperCore.h"
+#include "MinesweeperTypes.h"
+
+/**
+ * Builds Minesweeper games on a background task
+ * Keeps at most one game in flight or ready, tagged with the settings it was requested for. The owner
+ * prefetches the next game while the current one is played, then takes it when a new game is started.
+ * All methods are meant to be called from the game thread.
+ */
+class MINESWEEPER_API FMinesweeperGameGenerator
+{
+public:
+	~FMinesweeperGameGenerator();
+
+	/** Starts building a game for the given settings, unless one is already built or being built for them */
+	void Prefetch(const FMinesweeperGameSettings& InSettings);
+
+	/** Hands over the finished game for the given settings, null if there is none yet */
+	TSharedPtr<FMinesweeperCore> TakeReadyGame(const FMinesweeperGameSettings& InSettings);
+
+	/** Progress in [0, 1] of the game being built, 0 when there is none */
+	float GetProgress() const;
+
+private:
+	/** Abandons the current job, its task finishes early and drops the result */
+	void CancelCurrentJob();
+
+	struct FGenerationJob;
+	TSharedPtr<FGenerationJob> CurrentJob;
+};
@@ -0,0 +1,94 @@
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Player interactions the latency probe tells apart */
+enum class EMinesweeperLatencyOperation : uint8
+{
+	Reveal,
+	Flag
+};
+
+/**
+ * Measures how long a tile interaction takes to show up on screen
+ * Each interaction is timestamped three times: when the input handler receives the click, when the core has
+ * finished the move and broadcast its change set, and at the first board paint after the view caught up with
+ * that change set. Samples are kept per operation and board size, Minesweeper.LatencyReport prints their
+ * percentiles.
+ *
+ * Slate events carry no OS timestamp, so the input time is when the widget handles the click, after any
+ * time the event waited in the message queue.
+ * Only one interaction is followed at a time, a click landing before the previous one was painted replaces it.
+ * Game thread only, off until Minesweeper.LatencyProbe is set.
+ */
+class MINESWEEPER_API FMinesweeperLatencyProbe
+{
+public:
+	static bool IsEnabled() { return bEnabled; }
+	static void SetEnabled(const bool bInEnabled);
+
+	/** A tile input was received, starts following a new interaction */
+	static void BeginInteraction(const EMinesweeperLatencyOperation Operation)
+	{
+		if (bEnabled)
+		{
+			BeginInteractionImpl(Operation);
+		}
+	}
+
+	/** The core broadcast the change set of the interaction, the board size picks the series it is reported in */
+	static void MarkCoreFinished(const int32 BoardWidth, const int32 BoardHeight)
+	{
+		if (Stage == EStage::Input)
+		{
+			MarkCoreFinishedImpl(BoardWidth, BoardHeight);
+		}
+	}
+
+	/** Every tile change of the interaction has been pushed into the board view */
+	static void MarkViewUpdated()
+	{
+		if (Stage == EStage::CoreFinished)
+		{
+			Stage = EStage::ViewUpdated;
+		}
+	}
+
+	/** A paint that shows tile changes is running, the first one after MarkViewUpdated() completes the sample */
+	static void MarkPainted()
+	{
+		if (Stage == EStage::ViewUpdated)
+		{
+			MarkPaintedImpl();
+		}
+	}
+
+	/** Logs p50/p95/p99 of every series */
+	static void LogReport();
+
+	/** Drops all samples */
+	static void Reset();
+
+	static const TCHAR* GetOperationName(const EMinesweeperLatencyOperation Operation);
+
+	/** Samples kept per series, the oldest are overwritten */
+	static constexpr int32 MaxSamplesPerSeries = 4096;
+
+private:
+	enum class EStage : uint8
+	{
+		Idle,
+		Input,
+		CoreFinished,
+		ViewUpdated
+	};
+
+	static void BeginInteractionImpl(const EMinesweeperLatencyOperation Operation);
+	static void MarkCoreFinishedImpl(const int32 BoardWidth, const int32 BoardHeight);
+	static void MarkPaintedImpl();
+
+	static bool bEnabled;
+	static EStage Stage;
+};
@@ -5,34 +5,61 @@
 #include "CoreMinimal.h"
 #include "Engine/Engine.h"
 
-MINESWEEPER_API DECLARE_LOG_CATEGORY_EXTERN(LogMinesweeper, Display, All);
-
 /**
  * Logging system for the Minesweeper plugin
  * 
  * Provides convenient macros for different log levels with automatic function name inclusion
- * Can be easily enabled/disabled for the entire plugin via MINESWEEPER_LOG_ENABLE
+ * Can be easily enabled/disabled for the entire plugin via MINESWEEPER_LOG_ENABLE, or trimmed per category
+ * and verbosity at compile time via the MINESWEEPER_*_LOG_COMPILE_VERBOSITY defines (any ELogVerbosity name,
+ * e.g. add "MINESWEEPER_MOVES_LOG_COMPILE_VERBOSITY=Warning" to the module's PublicDefinitions).
+ * Statements above the compile time verbosity of their category are compiled out entirely.
+ *
+ * Per-tile events are not logged at all, they go to the binary trace in MinesweeperTrace.h.
  */
 
 // Master switch for all logging in this plugin (1 = enabled, 0 = disabled)
+#ifndef MINESWEEPER_LOG_ENABLE
 #define MINESWEEPER_LOG_ENABLE 1
+#endif
+
+// General plugin, generation and UI messages
+#ifndef MINESWEEPER_LOG_COMPILE_VERBOSITY
+#define MINESWEEPER_LOG_COMPILE_VERBOSITY All
+#endif
+
+// One message per player move (clicks, reveals, flags), the only ones on the reveal path
+#ifndef MINESWEEPER_MOVES_LOG_COMPILE_VERBOSITY
+#define MINESWEEPER_MOVES_LOG_COMPILE_VERBOSITY All
+#endif
+
+MINESWEEPER_API DECLARE_LOG_CATEGORY_EXTERN(LogMinesweeper, Display, MINESWEEPER_LOG_COMPILE_VERBOSITY);
+MINESWEEPER_API DECLARE_LOG_CATEGORY_EXTERN(LogMinesweeperMoves, Display, MINESWEEPER_MOVES_LOG_COMPILE_VERBOSITY);
 
 #if MINESWEEPER_LOG_ENABLE
 
-#define MS_LOG(type, msg, ...) UE_LOG(LogMinesweeper, type, TEXT("[%s] - %s"), *FString(__FUNCTION__), *FString::Printf(TEXT(msg), ##__VA_ARGS__))
-#define MS_DISPLAY(msg, ...) UE_LOG(LogMinesweeper, Display, TEXT("[%s] - %s"), *FString(__FUNCTION__), *FString::Printf(TEXT(msg), ##__VA_ARGS__))
-#define MS_WARNING(msg, ...) UE_LOG(LogMinesweeper, Warning, TEXT("[%s] - %s"), *FString(__FUNCTION__), *FString::Printf(TEXT(msg), ##__VA_ARGS__))
-#define MS_ERROR(msg, ...) UE_LOG(LogMinesweeper, Error, TEXT("[%s] - %s"), *FString(__FUNCTION__), *FString::Printf(TEXT(msg), ##__VA_ARGS__))
-#define MS_FATAL(msg, ...) UE_LOG(LogMinesweeper, Fatal, TEXT("[%s] - %s"), *FString(__FUNCTION__), *FString::Printf(TEXT(msg), ##__VA_ARGS__))
+// Formats straight into the log line, the arguments are only evaluated when the category and verbosity are active
+#define MS_LOG_CATEGORY(category, type, msg, ...) UE_LOG(category, type, TEXT("[%s] - ") TEXT(msg), ANSI_TO_TCHAR(__FUNCTION__), ##__VA_ARGS__)
+
+#define MS_LOG(type, msg, ...) MS_LOG_CATEGORY(LogMinesweeper, type, msg, ##__VA_ARGS__)
+#define MS_DISPLAY(msg, ...) MS_LOG_CATEGORY(LogMinesweeper, Display, msg, ##__VA_ARGS__)
+#define MS_WARNING(msg, ...) MS_LOG_CATEGORY(LogMinesweeper, Warning, msg, ##__VA_ARGS__)
+#define MS_ERROR(msg, ...) MS_LOG_CATEGORY(LogMinesweeper, Error, msg, ##__VA_ARGS__)
+#define MS_FATAL(msg, ...) MS_LOG_CATEGORY(LogMinesweeper, Fatal, msg, ##__VA_ARGS__)
+
+#define MS_MOVE_DISPLAY(msg, ...) MS_LOG_CATEGORY(LogMinesweeperMoves, Display, msg, ##__VA_ARGS__)
+#define MS_MOVE_VERBOSE(msg, ...) MS_LOG_CATEGORY(LogMinesweeperMoves, Verbose, msg, ##__VA_ARGS__)
 
 #else
 
 // When logging is disabled, all macros become no-ops
 
+#define MS_LOG_CATEGORY(category, type, msg, ...)
 #define MS_LOG(type, msg, ...)
 #define MS_DISPLAY(msg, ...)
 #define MS_WARNING(msg, ...)
 #define MS_ERROR(msg, ...)
 #define MS_FATAL(msg, ...)
+#define MS_MOVE_DISPLAY(msg, ...)
+#define MS_MOVE_VERBOSE(msg, ...)
 
 #endif // MINESWEEPER_LOG_ENABLE
@@ -0,0 +1,57 @@
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+
+/**
+ * Profiling instrumentation for the Minesweeper plugin
+ * Where stats are compiled in, scopes are cycle stats ("stat Minesweeper" in the console), which Unreal Insights
+ * also shows as CPU events (-trace=cpu). Builds without stats record them as CPU events on the Minesweeper trace
+ * channel instead ("Trace.Enable Minesweeper" in the console, or -trace=cpu,Minesweeper).
+ * Allocations are tagged for the Low Level Memory tracker (-llm, then "stat LLMFULL"), split into the core and the
+ * widget layer. Minesweeper.MemoryReport prints the same split per live session and per board size.
+ */
+
+UE_TRACE_CHANNEL_EXTERN(MinesweeperChannel, MINESWEEPER_API);
+
+LLM_DECLARE_TAG_API(Minesweeper_Core, MINESWEEPER_API);
+LLM_DECLARE_TAG_API(Minesweeper_UI, MINESWEEPER_API);
+
+DECLARE_STATS_GROUP(TEXT("Minesweeper"), STATGROUP_Minesweeper, STATCAT_Advanced);
+
+// Core
+DECLARE_CYCLE_STAT_EXTERN(TEXT("InitializeGame"), STAT_Minesweeper_InitializeGame, STATGROUP_Minesweeper, MINESWEEPER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("PlaceBombs"), STAT_Minesweeper_PlaceBombs, STATGROUP_Minesweeper, MINESWEEPER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("ComputeAdjacentCounts"), STAT_Minesweeper_ComputeAdjacentCounts, STATGROUP_Minesweeper, MINESWEEPER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("ComputeZeroRegions"), STAT_Minesweeper_ComputeZeroRegions, STATGROUP_Minesweeper, MINESWEEPER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("RevealTile"), STAT_Minesweeper_RevealTile, STATGROUP_Minesweeper, MINESWEEPER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("ToggleFlag"), STAT_Minesweeper_ToggleFlag, STATGROUP_Minesweeper, MINESWEEPER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("ApplyMoves"), STAT_Minesweeper_ApplyMoves, STATGROUP_Minesweeper, MINESWEEPER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("FloodReveal"), STAT_Minesweeper_FloodReveal, STATGROUP_Minesweeper, MINESWEEPER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("RevealZeroRegion"), STAT_Minesweeper_RevealZeroRegion, STATGROUP_Minesweeper, MINESWEEPER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("CheckWinCondition"), STAT_Minesweeper_CheckWinCondition, STATGROUP_Minesweeper, MINESWEEPER_API);
+
+// UI
+DECLARE_CYCLE_STAT_EXTERN(TEXT("RefreshGameBoardUI"), STAT_Minesweeper_RefreshGameBoardUI, STATGROUP_Minesweeper, MINESWEEPER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("ApplyTileChangesToView"), STAT_Minesweeper_ApplyTileChangesToView, STATGROUP_Minesweeper, MINESWEEPER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("UpdateTileButton"), STAT_Minesweeper_UpdateTileButton, STATGROUP_Minesweeper, MINESWEEPER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("PaintBoard"), STAT_Minesweeper_PaintBoard, STATGROUP_Minesweeper, MINESWEEPER_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("RefreshLevelOfDetail"), STAT_Minesweeper_RefreshLevelOfDetail, STATGROUP_Minesweeper, MINESWEEPER_API);
+
+// Counters, per frame unless noted
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Tiles Revealed By Clicks"), STAT_Minesweeper_TilesRevealedPerClick, STATGROUP_Minesweeper, MINESWEEPER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Flood Size"), STAT_Minesweeper_FloodSize, STATGROUP_Minesweeper, MINESWEEPER_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Tiles Painted"), STAT_Minesweeper_TilesPainted, STATGROUP_Minesweeper, MINESWEEPER_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Tile Widgets Alive"), STAT_Minesweeper_TileWidgetsAlive, STATGROUP_Minesweeper, MINESWEEPER_API);
+
+/** Cycle stat where stats exist, a CPU trace scope named after the stat otherwise, never both */
+#if STATS
+#define MS_SCOPE_CYCLE_COUNTER(Stat) SCOPE_CYCLE_COUNTER(Stat)
+#else
+#define MS_SCOPE_CYCLE_COUNTER(Stat) TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Stat, MinesweeperChannel)
+#endif
@@ -0,0 +1,83 @@
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <atomic>
+
+// Compiles the per-tile trace in or out, it is off at runtime until Minesweeper.Trace is set either way
+#ifndef MINESWEEPER_TRACE_ENABLE
+#define MINESWEEPER_TRACE_ENABLE !UE_BUILD_SHIPPING
+#endif
+
+enum class EMinesweeperTraceEvent : uint8
+{
+	/** A tile was revealed on its own (click or chord), Value is its adjacent bomb count, or -1 for a bomb */
+	TileRevealed,
+
+	/** A tile was revealed by a flood fill, Value is its adjacent bomb count */
+	TileFloodRevealed,
+
+	/** A precomputed zero region was revealed in bulk, TileIndex is the clicked tile, Value the tiles it opened */
+	ZeroRegionRevealed,
+
+	/** Value is 1 when the flag was set, 0 when it was cleared */
+	TileFlagged,
+
+	/** A revealed number was chorded, Value is the number of hidden neighbours it revealed */
+	TileChorded,
+
+	/** TileIndex is unused, Value is 1 for a win and 0 for a loss */
+	GameEnded
+};
+
+/** One fixed size, binary trace record */
+struct FMinesweeperTraceRecord
+{
+	uint64 Cycles = 0;
+	int32 TileIndex = 0;
+	int32 Value = 0;
+	EMinesweeperTraceEvent Event = EMinesweeperTraceEvent::TileRevealed;
+};
+
+/**
+ * Ring buffer of per-tile game events
+ * Recording a tile event is a flag test and a 24 byte store, cheap enough for the flood fill, where logging
+ * a line per tile would not be. The buffer keeps the most recent events and is only formatted when dumped
+ * with Minesweeper.DumpTrace.
+ */
+class MINESWEEPER_API FMinesweeperTrace
+{
+public:
+	static bool IsEnabled() { return bEnabled.load(std::memory_order_relaxed); }
+
+	/** Allocates the buffer on first enable, disabling keeps the recorded events for dumping */
+	static void SetEnabled(const bool bInEnabled);
+
+	static void Record(const EMinesweeperTraceEvent Event, const int32 TileIndex, const int32 Value)
+	{
+		const uint64 Slot = NextRecord.fetch_add(1, std::memory_order_relaxed);
+		Records[Slot & (Capacity - 1)] = { FPlatformTime::Cycles64(), TileIndex, Value, Event };
+	}
+
+	/** Copies out up to MaxRecords of the most recent events, oldest first */
+	static void GetRecentRecords(const int32 MaxRecords, TArray<FMinesweeperTraceRecord>& OutRecords);
+
+	static const TCHAR* GetEventName(const EMinesweeperTraceEvent Event);
+
+	/** Events kept, a power of two */
+	static constexpr uint64 Capacity = 1 << 16;
+
+private:
+	static std::atomic<bool> bEnabled;
+	static std::atomic<uint64> NextRecord;
+	static FMinesweeperTraceRecord* Records;
+};
+
+#if MINESWEEPER_TRACE_ENABLE
+// The arguments are only evaluated while the trace is enabled
+#define MS_TRACE(Event, TileIndex, Value) do { if (FMinesweeperTrace::IsEnabled()) { FMinesweeperTrace::Record(EMinesweeperTraceEvent::Event, (TileIndex), (Value)); } } while (0)
+#else
+#define MS_TRACE(Event, TileIndex, Value)
+#endif
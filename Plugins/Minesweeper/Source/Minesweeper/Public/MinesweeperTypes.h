@@ -10,6 +10,9 @@ static constexpr int32 MineSweeperGameGridMax = 50;
 static constexpr int32 MineSweeperBombCountMin = 1;
 static constexpr int32 MineSweeperBombCountMax = 500;
 
+// Large board mode limits, bomb count is only limited by the board size
+static constexpr int32 MineSweeperLargeGameGridMax = 16384;
+
 enum class EMinesweeperGameState : uint8
 {
 	NotStarted,
@@ -18,6 +21,16 @@ enum class EMinesweeperGameState : uint8
 	Lost
 };
 
+/** How board cells are laid out in memory */
+enum class EMinesweeperCellLayout : uint8
+{
+	/** Padded rows, one after another. Cheapest index math, best for small and medium boards */
+	RowMajor,
+
+	/** 8x8 blocks, each block one 64-bit word per plane. Vertical neighbours stay on the same cache line, best for huge boards */
+	Blocked8x8
+};
+
 struct MINESWEEPER_API FMinesweeperTile
 {
 	/** Whether this tile contains a bomb */
@@ -35,6 +48,141 @@ struct MINESWEEPER_API FMinesweeperTile
 	FMinesweeperTile() = default;
 };
 
+enum class EMinesweeperMoveType : uint8
+{
+	Reveal,
+	Flag,
+	Unflag,
+
+	/** Reveals the hidden neighbours of a revealed number whose flags already match its count */
+	Chord
+};
+
+/** A single player move, for batched submission */
+struct FMinesweeperMove
+{
+	EMinesweeperMoveType Type = EMinesweeperMoveType::Reveal;
+	int32 X = 0;
+	int32 Y = 0;
+
+	FMinesweeperMove() = default;
+
+	FMinesweeperMove(const EMinesweeperMoveType InType, const int32 InX, const int32 InY)
+		: Type(InType)
+		, X(InX)
+		, Y(InY) {}
+};
+
+/** Per-tile state bits, as reported by change sets */
+enum class EMinesweeperTileState : uint8
+{
+	None = 0,
+	Bomb = 1 << 0,
+	Revealed = 1 << 1,
+	Flagged = 1 << 2
+};
+ENUM_CLASS_FLAGS(EMinesweeperTileState);
+
+/** One tile touched by a core operation */
+struct FMinesweeperTileChange
+{
+	/** Row-major tile index (Y * Width + X) */
+	int32 TileIndex = INDEX_NONE;
+
+	EMinesweeperTileState OldState = EMinesweeperTileState::None;
+	EMinesweeperTileState NewState = EMinesweeperTileState::None;
+
+	FMinesweeperTileChange() = default;
+
+	FMinesweeperTileChange(const int32 InTileIndex, const EMinesweeperTileState InOldState, const EMinesweeperTileState InNewState)
+		: TileIndex(InTileIndex)
+		, OldState(InOldState)
+		, NewState(InNewState) {}
+};
+
+/**
+ * Safe tiles an opening revealed, as one 64-bit word of the board's cell planes
+ * Bit N stands for cell index WordIndex * 64 + N, FMinesweeperBoard::ForEachCellOfWord() maps it back to tiles.
+ */
+struct FMinesweeperRevealedCells
+{
+	int32 WordIndex = INDEX_NONE;
+	uint64 CellMask = 0;
+
+	FMinesweeperRevealedCells() = default;
+
+	FMinesweeperRevealedCells(const int32 InWordIndex, const uint64 InCellMask)
+		: WordIndex(InWordIndex)
+		, CellMask(InCellMask) {}
+};
+
+/**
+ * Everything a single core operation changed
+ * Consumers apply this instead of re-reading the whole board, so their cost follows the size of the change.
+ */
+struct MINESWEEPER_API FMinesweeperChangeSet
+{
+	/** Tiles whose state bits changed, in the order they changed. A tile touched twice (a winning flag that the game end then reveals) appears twice, the last entry holds its final state. */
+	TArray<FMinesweeperTileChange> TileChanges;
+
+	/**
+	 * Tiles revealed in bulk by openings (zero regions and flood reveals), 64 cells per entry
+	 * Every one of them went from hidden, unflagged and safe to revealed, so no per-tile state is kept. Single reveals, flags, chorded tiles and the game end stay in TileChanges.
+	 * Apply these after TileChanges: a batch may unflag a tile before opening it, and a revealed safe tile never changes again.
+	 */
+	TArray<FMinesweeperRevealedCells> RevealedCells;
+
+	EMinesweeperGameState OldGameState = EMinesweeperGameState::NotStarted;
+	EMinesweeperGameState NewGameState = EMinesweeperGameState::NotStarted;
+
+	bool HasGameStateChanged() const { return OldGameState != NewGameState; }
+	bool IsEmpty() const { return TileChanges.Num() == 0 && RevealedCells.Num() == 0 && !HasGameStateChanged(); }
+
+	/** Clears the changes and starts a new set from the given game state, keeps the allocation */
+	void Reset(const EMinesweeperGameState InGameState)
+	{
+		TileChanges.Reset();
+		RevealedCells.Reset();
+		OldGameState = InGameState;
+		NewGameState = InGameState;
+	}
+};
+
+/**
+ * Lightweight by-value handle returned by tile queries
+ * The board is stored packed, so there is no tile object to point at. The proxy keeps the
+ * pointer-like usage (null checks, -> access) working for callers.
+ */
+struct MINESWEEPER_API FMinesweeperTileProxy
+{
+	FMinesweeperTileProxy() = default;
+
+	explicit FMinesweeperTileProxy(const FMinesweeperTile& InTile)
+		: Tile(InTile)
+		, bIsValid(true) {}
+
+	bool IsValid() const { return bIsValid; }
+	explicit operator bool() const { return bIsValid; }
+	bool operator==(TYPE_OF_NULLPTR) const { return !bIsValid; }
+	bool operator!=(TYPE_OF_NULLPTR) const { return bIsValid; }
+
+	const FMinesweeperTile* operator->() const
+	{
+		check(bIsValid);
+		return &Tile;
+	}
+
+	const FMinesweeperTile& operator*() const
+	{
+		check(bIsValid);
+		return Tile;
+	}
+
+private:
+	FMinesweeperTile Tile;
+	bool bIsValid = false;
+};
+
 struct MINESWEEPER_API FMinesweeperGameSettings
 {
 	/** Width of the game grid */
@@ -46,19 +194,41 @@ struct MINESWEEPER_API FMinesweeperGameSettings
 	/** Number of bombs on the board */
 	int32 BombCount = 10;
 
+	/** Seed for bomb placement, the same seed and size always give the same board. 0 picks a new seed per game */
+	int32 RandomSeed = 0;
+
+	/** Lifts the regular size and bomb caps, for stress testing very large boards */
+	bool bLargeBoard = false;
+
+	/** Memory layout of the board cells, does not change which board a seed generates */
+	EMinesweeperCellLayout CellLayout = EMinesweeperCellLayout::RowMajor;
+
 	FMinesweeperGameSettings() = default;
 
-	FMinesweeperGameSettings(const int32 InGridWidth, const int32 InGridHeight, const int32 InBombCount)
+	FMinesweeperGameSettings(const int32 InGridWidth, const int32 InGridHeight, const int32 InBombCount, const int32 InRandomSeed = 0)
 		: GridWidth(InGridWidth)
 		, GridHeight(InGridHeight)
-		, BombCount(InBombCount) {}
+		, BombCount(InBombCount)
+		, RandomSeed(InRandomSeed) {}
 
 	/** Validates and clamps the settings to valid ranges */
 	void ValidateAndClamp()
 	{
-		GridWidth = FMath::Clamp(GridWidth, MineSweeperGameGridMin, MineSweeperGameGridMax);
-		GridHeight = FMath::Clamp(GridHeight, MineSweeperGameGridMin, MineSweeperGameGridMax);
-		BombCount = FMath::Clamp(BombCount, MineSweeperBombCountMin, FMath::Min(MineSweeperBombCountMax, GridWidth * GridHeight - 1));
+		GridWidth = FMath::Clamp(GridWidth, MineSweeperGameGridMin, GetMaxGridSize());
+		GridHeight = FMath::Clamp(GridHeight, MineSweeperGameGridMin, GetMaxGridSize());
+		BombCount = FMath::Clamp(BombCount, MineSweeperBombCountMin, FMath::Min(GetMaxBombCount(), GridWidth * GridHeight - 1));
+	}
+
+	/** Upper bound for width and height in the current mode */
+	int32 GetMaxGridSize() const
+	{
+		return bLargeBoard ? MineSweeperLargeGameGridMax : MineSweeperGameGridMax;
+	}
+
+	/** Upper bound for the bomb count in the current mode */
+	int32 GetMaxBombCount() const
+	{
+		return bLargeBoard ? MineSweeperLargeGameGridMax * MineSweeperLargeGameGridMax - 1 : MineSweeperBombCountMax;
 	}
 
 	/** Returns the total number of tiles */
@@ -66,4 +236,19 @@ struct MINESWEEPER_API FMinesweeperGameSettings
 	{
 		return GridWidth * GridHeight;
 	}
+
+	bool operator==(const FMinesweeperGameSettings& Other) const
+	{
+		return GridWidth == Other.GridWidth
+			&& GridHeight == Other.GridHeight
+			&& BombCount == Other.BombCount
+			&& RandomSeed == Other.RandomSeed
+			&& bLargeBoard == Other.bLargeBoard
+			&& CellLayout == Other.CellLayout;
+	}
+
+	bool operator!=(const FMinesweeperGameSettings& Other) const
+	{
+		return !(*this == Other);
+	}
 };
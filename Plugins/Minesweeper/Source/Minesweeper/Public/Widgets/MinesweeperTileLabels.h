@@ -0,0 +1,60 @@
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Fonts/ShapedTextFwd.h"
+#include "Fonts/SlateFontInfo.h"
+#include "MinesweeperTypes.h"
+#include "Styling/SlateColor.h"
+
+/**
+ * Shared table of everything a tile can display
+ * There are only 11 labels (empty, 1-8, flag, bomb). Their text, color, glyphs and size are built once with the
+ * font, so drawing or updating a tile only copies references out of the table and never allocates or shapes text.
+ */
+class MINESWEEPER_API FMinesweeperTileLabels
+{
+public:
+	enum ELabel : int32
+	{
+		Empty = 0,
+		// 1-8 are the adjacent bomb counts
+		Flag = 9,
+		Bomb = 10,
+
+		Num
+	};
+
+	struct FLabel
+	{
+		FText Text;
+
+		/** Text shaped with Font at scale 1, drawn as is so painting a label never goes through the shaping cache */
+		FShapedGlyphSequencePtr ShapedGlyphs;
+
+		FSlateColor Color;
+
+		/** Size of the label in Font at scale 1 */
+		FVector2f Size = FVector2f::ZeroVector;
+	};
+
+	/** Built on first use, from the game thread */
+	static const FMinesweeperTileLabels& Get();
+
+	/** Label shown by a tile in the given state */
+	static ELabel GetLabelIndex(const EMinesweeperTileState State, const int32 AdjacentBombs);
+
+	/** Background tint of a tile in the given state */
+	static FLinearColor GetBackgroundColor(const EMinesweeperTileState State);
+
+	const FLabel& GetLabel(const ELabel Label) const { return Labels[Label]; }
+	const FLabel& GetLabel(const EMinesweeperTileState State, const int32 AdjacentBombs) const { return Labels[GetLabelIndex(State, AdjacentBombs)]; }
+	const FSlateFontInfo& GetFont() const { return Font; }
+
+private:
+	FMinesweeperTileLabels();
+
+	FLabel Labels[ELabel::Num];
+	FSlateFontInfo Font;
+};
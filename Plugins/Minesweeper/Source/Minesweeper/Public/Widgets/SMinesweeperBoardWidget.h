@@ -0,0 +1,166 @@
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MinesweeperCore.h"
+#include "Widgets/SLeafWidget.h"
+#include "Widgets/SMinesweeperTileButton.h"
+
+/**
+ * Whole Minesweeper board as a single, pannable and zoomable viewport
+ * Every visible tile is painted in OnPaint as one box and an optional label, and mouse input is mapped to
+ * tiles by coordinate math. When zoomed out too far for single tiles, the board is painted from a pyramid of
+ * per-block reveal and flag counts instead, so the paint cost depends on the viewport size, not the board size.
+ *
+ * Mouse wheel zooms around the cursor, middle mouse drag pans.
+ */
+class MINESWEEPER_API SMinesweeperBoardWidget : public SLeafWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SMinesweeperBoardWidget) {}
+
+		/** Game to display, only read from **/
+		SLATE_ARGUMENT(TWeakPtr<FMinesweeperCore>, GameCore)
+
+		/** Called when a hidden tile is left-clicked (reveal) **/
+		SLATE_EVENT(FOnTileInteraction, OnTileRevealed)
+
+		/** Called when a hidden tile is right-clicked (flag toggle) **/
+		SLATE_EVENT(FOnTileInteraction, OnTileFlagged)
+
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+
+	/** Switches to another game, the view is reset when the board size changes */
+	void SetGameCore(const TWeakPtr<FMinesweeperCore>& InGameCore);
+
+	/**
+	 * Takes a change set of the displayed game, every change set must come through here so the level of detail stays in sync
+	 * Tiles are painted straight from the core, so this only marks the level of detail rows the changes touched as stale.
+	 */
+	void ApplyChangeSet(const FMinesweeperChangeSet& ChangeSet);
+
+	/**
+	 * Recounts stale level of detail rows from the board, at least one and then more until EndTime passes
+	 * @return True once the level of detail matches the board
+	 */
+	bool RefreshLevelOfDetail(const double EndTime);
+
+	bool HasStaleLevelOfDetail() const { return NumStaleLodRows > 0; }
+
+	/** Memory held by this widget, the object itself plus the level of detail pyramid when it is built */
+	SIZE_T GetAllocatedSize() const;
+
+	/** Memory the widget holds for a board of the given size once it has been zoomed out far enough to build the pyramid */
+	static SIZE_T GetMaxAllocatedSize(const int32 BoardWidth, const int32 BoardHeight);
+
+	// SWidget interface
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+	virtual FReply OnMouseButtonDown(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent) override;
+	virtual FReply OnMouseButtonUp(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent) override;
+	virtual FReply OnMouseMove(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent) override;
+	virtual FReply OnMouseWheel(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent) override;
+	virtual void OnMouseLeave(const FPointerEvent& MouseEvent) override;
+
+protected:
+	virtual FVector2D ComputeDesiredSize(float LayoutScaleMultiplier) const override;
+
+private:
+	/** Checks the level of detail pyramid against the board after change sets */
+	friend struct FMinesweeperBoardWidgetTest;
+
+	/** Reveal and flag counts of one block of tiles, in one level of the level of detail pyramid */
+	struct FLodTexel
+	{
+		uint16 Revealed = 0;
+		uint16 Flagged = 0;
+	};
+
+	struct FLodLevel
+	{
+		/** Texels per row and column, each texel covers (LodBaseBlockSize << Level) tiles square */
+		int32 Width = 0;
+		int32 Height = 0;
+		TArray<FLodTexel> Texels;
+	};
+
+	int32 PaintTiles(const FMinesweeperCore& GameCore, const FGeometry& AllottedGeometry, const FSlateRect& LocalViewRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, const bool bEnabled) const;
+	int32 PaintLevelOfDetail(const FMinesweeperCore& GameCore, const FGeometry& AllottedGeometry, const FSlateRect& LocalViewRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, const bool bEnabled) const;
+
+	/** Builds the level of detail pyramid from the board on first use */
+	void BuildLodPyramid(const FMinesweeperCore& GameCore) const;
+
+	/** Recounts one texel row of the base level from the board */
+	void CountLodRow(const FMinesweeperBoard& Board, const int32 TexelY) const;
+
+	/** Sums one texel row of a level from the 2x2 texels below it */
+	void SumLodRow(const int32 Level, const int32 TexelY) const;
+
+	/** Marks the base level texel rows covering tile rows [FirstY, LastY] stale */
+	void MarkLodRowsStale(const int32 FirstY, const int32 LastY);
+
+	/** Maps a screen space position to tile coordinates, false when it is off the board */
+	bool GetTileAtScreenPosition(const FGeometry& MyGeometry, const FVector2D& ScreenPosition, int32& OutX, int32& OutY) const;
+
+	/** Zoom level at which the whole board fits the viewport */
+	float GetFitTilePitch(const FVector2f& ViewSize) const;
+
+	/** Sets the zoom, keeping the board point under LocalAnchor in place */
+	void SetTilePitch(const float NewTilePitch, const FVector2f& LocalAnchor, const FVector2f& ViewSize);
+
+	/** Keeps the board inside the viewport */
+	void ClampView(const FVector2f& ViewSize);
+
+	bool IsShowingTiles() const { return TilePitch >= MinDetailTilePitch; }
+
+	/** Default tile pitch in slate units, the visible tile is TileSize minus TileGap */
+	static constexpr float TileSize = 24.0f;
+	static constexpr float TileGap = 2.0f;
+
+	/** Largest viewport the widget asks for, bigger boards are panned */
+	static constexpr float MaxDesiredViewSize = 1024.0f;
+
+	/** Below this pitch tiles are no longer painted one by one but aggregated */
+	static constexpr float MinDetailTilePitch = 4.0f;
+
+	/** Below this pitch labels are skipped, they would not be readable */
+	static constexpr float MinLabelTilePitch = 12.0f;
+	static constexpr float MaxTilePitch = 96.0f;
+
+	/** Tiles per texel side at the base of the pyramid, and texel pitch the painted level is picked for */
+	static constexpr int32 LodBaseBlockSize = 8;
+	static constexpr int32 NumLodLevels = 5;
+	static constexpr float MinLodTexelPitch = 4.0f;
+
+	TWeakPtr<FMinesweeperCore> GameCoreWeak;
+
+	FOnTileInteraction OnTileRevealed;
+	FOnTileInteraction OnTileFlagged;
+
+	/** Board point at the top left of the viewport, in tiles */
+	FVector2f ViewOrigin = FVector2f::ZeroVector;
+
+	/** Size of one tile on screen, in slate units */
+	float TilePitch = TileSize;
+
+	/** Board size the view was set up for */
+	int32 ViewBoardWidth = 0;
+	int32 ViewBoardHeight = 0;
+
+	/** Middle mouse panning */
+	bool bIsPanning = false;
+	FVector2f LastPanPosition = FVector2f::ZeroVector;
+
+	/** Tile under the mouse, INDEX_NONE when the mouse is not over the board */
+	int32 HoveredTileX = INDEX_NONE;
+	int32 HoveredTileY = INDEX_NONE;
+
+	/** Level of detail pyramid, built lazily the first time the board is zoomed out that far, then kept in sync by change sets */
+	mutable TArray<FLodLevel> LodLevels;
+
+	/** Base level texel rows that are behind the board, each level above follows its base rows when they are recounted */
+	mutable TBitArray<> StaleLodRows;
+	mutable int32 NumStaleLodRows = 0;
+};
@@ -11,7 +11,8 @@ DECLARE_DELEGATE_TwoParams(FOnTileInteraction, const int32, const int32);
 /**
  * Custom button widget for Minesweeper tiles
  * Extends SButton to support right-click functionality for flagging mechanic
- * Handles its own state, appearance.
+ * Does not read the game itself, its owner pushes the tile state in whenever the core reports a change
+ * for the tile, so an idle tile costs nothing to tick or paint.
  */
 class MINESWEEPER_API SMinesweeperTileButton : public SButton
 {
@@ -27,9 +28,6 @@ public:
 		SLATE_ARGUMENT(int32, TileX)
 		SLATE_ARGUMENT(int32, TileY)
 
-		/** Reference to game core for tile data access **/
-		SLATE_ARGUMENT(TWeakPtr<FMinesweeperCore>, GameCore)
-
 		/** Called when tile is left-clicked (reveal) **/
 		SLATE_EVENT(FOnTileInteraction, OnTileRevealed)
 
@@ -50,26 +48,29 @@ public:
 
 	SLATE_END_ARGS()
 
+	virtual ~SMinesweeperTileButton() override;
+
 	void Construct(const FArguments& InArgs);
 
+	/** Moves a pooled button to another tile */
+	void SetTileCoordinates(const int32 InTileX, const int32 InTileY);
+
+	/** Updates the cached appearance, cheap to call when nothing changed */
+	void SetTileState(const EMinesweeperTileState InState, const int32 InAdjacentBombs, const bool bInteractable);
+
+	/** Approximate memory of one tile of the legacy grid: the button, its content widgets and its grid slot. Text layout caches are not counted. */
+	static SIZE_T GetEstimatedTileSize();
+
 public:
 	virtual FReply OnMouseButtonDown(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent) override;
 	virtual FReply OnMouseButtonUp(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent) override;
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
 
 private:
 	/** Internal event handlers **/
 	FReply ExecuteOnLeftClick() const;
 	FReply ExecuteOnRightClick() const;
 
-	/** UI update for this tile **/
-	FText GetTileDisplayText() const;
-	FSlateColor GetTileTextColor() const;
-	FSlateColor GetTileBackgroundColor() const;
-	FSlateColor GetTileTextColorBasedOnAdjacentBomb(const int32 AdjacentBombCount) const;
-
-	/** Helper to get current tile data safely **/
-	const FMinesweeperTile* GetCurrentTileData() const;
-
 private:
 	/** Tile coordinates */
 	int32 TileX = 0;
@@ -79,6 +80,13 @@ private:
 	FOnTileInteraction OnTileRevealed;
 	FOnTileInteraction OnTileFlagged;
 
-	/** Weak reference to game core */
-	TWeakPtr<FMinesweeperCore> GameCoreWeak;
+	/** Tile state the appearance was last built for */
+	EMinesweeperTileState TileState = EMinesweeperTileState::None;
+	int32 AdjacentBombs = 0;
+	bool bHasTileState = false;
+
+	/** Set when the appearance changed, cleared by the paint that shows it */
+	mutable bool bStateChangedSincePaint = false;
+
+	TSharedPtr<STextBlock> TileTextBlock;
 };
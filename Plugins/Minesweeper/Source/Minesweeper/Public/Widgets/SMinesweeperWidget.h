@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "MinesweeperCore.h"
+#include "MinesweeperGameGenerator.h"
 #include "MinesweeperTypes.h"
 #include "Widgets/Input/SSpinBox.h"
 #include "Widgets/SCompoundWidget.h"
@@ -17,21 +18,35 @@ public:
 	SLATE_BEGIN_ARGS(SMinesweeperWidget) {}
 	SLATE_END_ARGS()
 
+	virtual ~SMinesweeperWidget() override;
+
 	void Construct(const FArguments& InArgs);
 
+	/** Game being played in this session */
+	TSharedPtr<const FMinesweeperCore> GetGameCore() const { return GameCore; }
+
+	/** Memory held by the board view of this session, the painted board or the legacy tile buttons and their queued changes */
+	SIZE_T GetBoardUIAllocatedSize() const;
+
 private:
+	/** Drives games and frames of the widget offscreen */
+	friend struct FMinesweeperSlateBenchmark;
+
 	// UI generation
 	TSharedRef<SWidget> CreateControlPanel();
 	TSharedRef<SWidget> CreateGameSettingsPanel();
 	TSharedRef<SWidget> CreateGameInfoPanel();
 	TSharedRef<SWidget> CreateGameBoard();
-	TSharedRef<SWidget> CreateTileButton(int32 X, int32 Y);
+	TSharedRef<class SMinesweeperTileButton> CreateTileButton(const int32 X, const int32 Y);
 
 	// UI Update Methods
 	void RefreshGameBoardUI();
+	void RefreshTileButtonGrid();
+	void UpdateTileButton(const int32 TileIndex) const;
 	void UpdateGameInfoDisplay() const;
 	void UpdateFlagCountDisplay() const;
 	void UpdateGameStatusDisplay() const;
+	void UpdateBoardSeedDisplay() const;
 
 	// UI callbacks
 	FReply OnGenerateNewGameClicked();
@@ -40,14 +55,32 @@ private:
 	void OnWidthUIValueChanged(const int32 NewValue);
 	void OnHeightUIValueChanged(const int32 NewValue);
 	void OnBombCountUIValueChanged(const int32 NewValue);
+	void OnSeedUIValueChanged(const int32 NewValue);
+	void OnLargeBoardUICheckStateChanged(const ECheckBoxState NewState);
 
 	// UI Attribute Getters (for dynamic UI updates)
 	FText GetGameStatusText(const EMinesweeperGameState GameState) const;
 	FText GetFlagCountText(const int32 FlaggedCount, const int32 TotalBombs) const;
-	bool IsTileButtonInteractable(const int32 X, const int32 Y) const;
 
 	// Game flow
 	void InitializeNewGame();
+	void StartGame(const TSharedPtr<FMinesweeperCore>& NewGameCore);
+	EActiveTimerReturnType WaitForGeneratedGame(const double InCurrentTime, const float InDeltaTime);
+
+	/** Builds the game for the pending settings ahead of New Game, skipped for large boards */
+	void PrefetchNextGame();
+
+	/** Prefetches for the pending settings once they stopped changing for a moment */
+	void SchedulePrefetch();
+	EActiveTimerReturnType PrefetchWhenIdle(const double InCurrentTime, const float InDeltaTime);
+	void OnGameCoreChangeSet(const FMinesweeperChangeSet& ChangeSet);
+
+	/** Brings the tile buttons up to date */
+	void ApplyTileChangesToView(const TConstArrayView<FMinesweeperTileChange> TileChanges);
+
+	/** Catches the view up within the frame budget: the level of detail of the painted board, or the queued button changes */
+	EActiveTimerReturnType ApplyPendingViewUpdates(const double InCurrentTime, const float InDeltaTime);
+	void CancelPendingViewUpdates();
 	void HandleGameStateChange(const EMinesweeperGameState NewState);
 	void ShowEndGameDialog() const;
 
@@ -55,14 +88,45 @@ private:
 	// Core Game Logic
 	TSharedPtr<FMinesweeperCore> GameCore;
 
+	/** Subscription to the change sets of GameCore, pushes tile changes into the board widgets */
+	FDelegateHandle ChangeSetHandle;
+
+	/** Builds games in the background, the next game for the pending settings is kept ready */
+	FMinesweeperGameGenerator GameGenerator;
+
+	/** Set while a new game was requested and its board is still being generated */
+	TSharedPtr<FActiveTimerHandle> GenerationTimerHandle;
+
+	/** Set while spin box edits wait to be prefetched, bPendingSettingsChanged when they changed again during the last idle period */
+	TSharedPtr<FActiveTimerHandle> PrefetchTimerHandle;
+	bool bPendingSettingsChanged = false;
+
+	/** Tile changes the button view has not caught up with yet, applied a few per frame from NextPendingTileChange on */
+	TArray<FMinesweeperTileChange> PendingTileChanges;
+	int32 NextPendingTileChange = 0;
+	TSharedPtr<FActiveTimerHandle> ViewUpdateTimerHandle;
+
 	// UI State
 	FMinesweeperGameSettings PendingGameSettings;
 
 	// UI Components
+	TSharedPtr<class SBox> GameBoardContainerUI;
+	TSharedPtr<class SMinesweeperBoardWidget> GameBoardWidgetUI;
+
+	/** Legacy one button per tile view, only built when Minesweeper.BoardView is 1 */
 	TSharedPtr<class SUniformGridPanel> GameBoardGridPanelUI;
+
+	/** Legacy view tile buttons, by tile index (Y * Width + X). Kept across games and rebound to each new core */
+	TArray<TSharedPtr<class SMinesweeperTileButton>> TileButtonsUI;
+
+	/** Size the tile buttons are currently laid out for in GameBoardGridPanelUI */
+	int32 TileGridWidth = 0;
+	int32 TileGridHeight = 0;
 	TSharedPtr<SSpinBox<int32>> WidthSpinBoxUI;
 	TSharedPtr<SSpinBox<int32>> HeightSpinBoxUI;
 	TSharedPtr<SSpinBox<int32>> BombCountSpinBoxUI;
+	TSharedPtr<SSpinBox<int32>> SeedSpinBoxUI;
 	TSharedPtr<STextBlock> GameStatusTextUI;
 	TSharedPtr<STextBlock> FlagCountTextUI;
+	TSharedPtr<STextBlock> BoardSeedTextUI;
 };